@@ -42,37 +42,77 @@ void Analyzer::DoDcAnalysis(const DcAnalysis dc_analysis) {
     std::vector<double> dc_value_vec;
 
     int scan_vsrc_index = FindNode(reduced_node_vec, "i_" + dc_analysis.Vsrc_name);
+    if (scan_vsrc_index < 0) {
+        cout << "Unknown source in .dc: " << dc_analysis.Vsrc_name << endl;
+        return;
+    }
+
+    NewtonSystem newton_system(reduced_mat, analysis_matrix.exp_analysis_vec, reduced_rhs,
+                               analysis_matrix.exp_rhs_vec, circuit.node_vec.size() - 1);
+    LuFactor lu;
+    NewtonSetting newton_setting(options);
+    newton_setting.lu = &lu;
+    newton_setting.stat = &run_stat;
+    // Each sweep point starts from the last converged solution.
+    vec result(node_num - 1, arma::fill::zeros);
+    int fail_num = 0;
+
+    // Eliminate the linear-only unknowns once, Newton then only runs on the
+    // unknowns touched by diodes.
+    SchurSystem schur;
+    bool use_schur = !circuit.diode_vec.empty() && BuildSchurSystem(newton_system, schur);
+    if (use_schur)
+        run_stat.factorization_num++;
 
     for (double v = start; v <= end + 1e-4; v += step) {
         mat scan_rhs = reduced_rhs;
         scan_rhs(scan_vsrc_index, 0) = v;
 
         if (!circuit.diode_vec.empty()) {
-            cout << "Nonlinear" << endl;
             // Nonlinear
-            vec result_n(node_num - 1, arma::fill::zeros);
-            vec result_n_plus_1(node_num - 1, arma::fill::zeros);
-
-            while (true) {
-                // Update the analysis matrix
-                arma::mat mat =
-                    AddExpTerm(analysis_matrix.exp_analysis_vec, result_n, reduced_mat);
-                // Update RHS
-                arma::mat rhs =
-                    AddExpTerm(analysis_matrix.exp_rhs_vec, result_n, scan_rhs);
-                // cout << "reduced_mat:" << endl << reduced_mat << endl;
-                // cout << "scan_rhs" << endl << scan_rhs << endl;
-                result_n_plus_1 = arma::solve(mat, rhs);
-                if (VecDifference(result_n, result_n_plus_1))
-                    break;
-                result_n = result_n_plus_1;
+            newton_system.rhs = scan_rhs;
+            if (dc_value_vec.empty()) {
+                LoadOperatingPoint(reduced_node_vec, result);
+                SeedNodeset(newton_system, result);
+            }
+            ConvergenceReport report;
+            bool converged;
+            if (use_schur) {
+                SetSchurRhs(schur, scan_rhs);
+                vec x = GetSchurNonlinearPart(schur, result);
+                converged = SolveOperatingPoint(schur.reduced, newton_setting, x, report);
+                if (converged)
+                    result = RecoverSchurSolution(schur, x);
+            } else {
+                converged =
+                    SolveOperatingPoint(newton_system, newton_setting, result, report);
+            }
+            if (!converged || report.strategy_vec.size() > 1 || report.pseudo_tran_ran) {
+                cout << "DC point " << dc_analysis.Vsrc_name << " = " << v << ":" << endl;
+                PrintConvergenceReport(report);
+            }
+            if (converged && dc_value_vec.empty())
+                SaveOperatingPoint(reduced_node_vec, result);
+            // A failed point is NaN, so the plot shows a gap instead of the
+            // previous solution.
+            if (converged)
+                dc_result_vec.push_back(result);
+            else {
+                dc_result_vec.push_back(vec(node_num - 1).fill(arma::datum::nan));
+                fail_num++;
             }
-            dc_result_vec.push_back(result_n_plus_1);
 
         } else {
-            // Linear
-
-            vec dc_result = arma::solve(reduced_mat, scan_rhs);
+            // Linear, the matrix is the same for every sweep point
+            if (!lu.valid) {
+                run_stat.factorization_num++;
+                if (!lu.Factorize(reduced_mat)) {
+                    cout << "Singular MNA matrix, no DC analysis" << endl;
+                    return;
+                }
+            }
+            vec dc_result = lu.Solve(vec(scan_rhs));
+            run_stat.solve_num++;
 
             // cout << "result: " << endl << dc_result << endl;
 
@@ -80,10 +120,142 @@ void Analyzer::DoDcAnalysis(const DcAnalysis dc_analysis) {
         }
         dc_value_vec.push_back(v);
     }
+    // Every point stays in the result, DcPlot draws the NaN ones as gaps.
+    if (fail_num > 0)
+        cout << fail_num << " of " << dc_value_vec.size()
+             << " DC points failed to converge and are set to NaN" << endl;
     dc_result = DcResult{dc_result_vec, dc_value_vec, reduced_node_vec};
 }
 
-void Analyzer::DoAcAnalysis(const AcAnalysis ac_analysis) {
+/**
+ * @brief .op: the DC operating point, printed as `v(node) = value` for the
+ * .print variables, or for every node without them.
+ *
+ * @param print_variable_vec
+ */
+void Analyzer::DoOpAnalysis(const vector<PrintVariable> print_variable_vec) {
+    const OperatingPoint& op = GetOperatingPoint();
+    if (!op.converged) {
+        cout << "Operating point failed" << endl;
+        return;
+    }
+
+    vector<PrintVariable> variable_vec = print_variable_vec;
+    if (variable_vec.empty())
+        for (NodeName node : circuit.node_vec)
+            if (node != "0")
+                variable_vec.push_back(PrintVariable{V, MAG, node});
+
+    for (PrintVariable print_variable : variable_vec) {
+        NodeName name = print_variable.print_i_v == I ? "i_" + print_variable.node
+                                                      : print_variable.node;
+        double value = 0;
+        if (op.node_index.contains(name))
+            value = op.result(op.node_index.value(name));
+        else if (name != "0") {
+            cout << "Unknown node in .print: " << print_variable.node << endl;
+            continue;
+        }
+        cout << PrintLabel(print_variable, false) << " = " << value << endl;
+    }
+}
+
+/**
+ * @brief Solve the DC operating point and factorize the Jacobian there. For a
+ * converged Newton solve only the columns stamped by diodes are refactored.
+ * The result is cached until the circuit changes.
+ *
+ * @return const OperatingPoint&
+ */
+const OperatingPoint& Analyzer::GetOperatingPoint() {
+    if (operating_point_ready)
+        return operating_point;
+    operating_point_ready = true;
+
+    AnalysisMatrix analysis_matrix = GetAnalysisMatrix(0);
+    int node_num = analysis_matrix.node_vec.size();
+
+    // `reduced` means remove the 0(gnd) node.
+    mat reduced_mat = GetReal(analysis_matrix.linear_analysis_mat(span(1, node_num - 1),
+                                                                  span(1, node_num - 1)));
+    mat reduced_rhs = GetReal(analysis_matrix.rhs(span(1, node_num - 1), 0));
+
+    OperatingPoint& op = operating_point;
+    op = OperatingPoint();
+    op.node_vec = analysis_matrix.node_vec;
+    op.node_vec.erase(op.node_vec.begin());
+    op.node_index = GetNodeIndex(op.node_vec);
+    op.system = NewtonSystem(reduced_mat, analysis_matrix.exp_analysis_vec, reduced_rhs,
+                             analysis_matrix.exp_rhs_vec, circuit.node_vec.size() - 1);
+    op.result = vec(node_num - 1, arma::fill::zeros);
+
+    if (circuit.diode_vec.empty()) {
+        run_stat.factorization_num++;
+        op.converged = op.lu.Factorize(reduced_mat);
+        if (op.converged) {
+            op.result = op.lu.Solve(reduced_rhs);
+            run_stat.solve_num++;
+        }
+        return op;
+    }
+
+    NewtonSetting newton_setting(options);
+    newton_setting.lu = &op.lu;
+    newton_setting.stat = &run_stat;
+    ConvergenceReport report;
+    LoadOperatingPoint(op.node_vec, op.result);
+    SeedNodeset(op.system, op.result);
+    op.converged = SolveOperatingPoint(op.system, newton_setting, op.result, report);
+    if (!op.converged || report.strategy_vec.size() > 1 || report.pseudo_tran_ran) {
+        cout << "Operating point:" << endl;
+        PrintConvergenceReport(report);
+    }
+    if (op.converged)
+        SaveOperatingPoint(op.node_vec, op.result);
+
+    // The stepping strategies leave a factorization of a modified matrix.
+    if (report.converged_strategy != "newton")
+        op.lu.valid = false;
+    if (FactorizeJacobian(op.system, op.result, op.lu, &run_stat) == 0)
+        op.converged = false;
+    return op;
+}
+
+/**
+ * @brief Small-signal model of the diodes at the operating point, on the
+ * reduced system: the conductance g_d = dI/dv, taken from the Jacobian, and
+ * the capacitance tt * g_d + cj0.
+ *
+ * @param op
+ * @param diode_g conductance stamps
+ * @param diode_c capacitance stamps
+ */
+void Analyzer::GetDiodeSmallSignal(const OperatingPoint& op, mat& diode_g, mat& diode_c) {
+    const int size = op.result.n_elem;
+    mat zero_mat(size, size, arma::fill::zeros);
+    diode_g = AddExpTerm(op.system.exp_analysis_vec, op.result, zero_mat);
+    diode_c.zeros(size, size);
+
+    for (const Junction& junction : GetJunctions(op.system.exp_rhs_vec)) {
+        const Diode& diode = circuit.diode_vec[junction.diode_index];
+        DiodeModel model = FindDiodeModel(circuit, diode.model);
+        double g = junction.i_sat / junction.vt *
+                   LimitedExp(JunctionVoltage(junction, op.result) / junction.vt);
+        double c = model.tt * g + model.cj0;
+
+        int i_1 = junction.node_1_index, i_2 = junction.node_2_index;
+        if (i_1 >= 0)
+            diode_c(i_1, i_1) += c;
+        if (i_2 >= 0)
+            diode_c(i_2, i_2) += c;
+        if (i_1 >= 0 && i_2 >= 0) {
+            diode_c(i_1, i_2) -= c;
+            diode_c(i_2, i_1) -= c;
+        }
+    }
+}
+
+vector<double> GetScanFrequencies(const AcAnalysis ac_analysis) {
     vector<double> scan_freq_vec;
 
     double f_start = ac_analysis.f_start;
@@ -130,9 +302,24 @@ void Analyzer::DoAcAnalysis(const AcAnalysis ac_analysis) {
         }
         default: break;
     }
+    return scan_freq_vec;
+}
+
+void Analyzer::DoAcAnalysis(const AcAnalysis ac_analysis) {
+    vector<double> scan_freq_vec = GetScanFrequencies(ac_analysis);
 
     vector<arma::cx_vec> ac_result_vec;
 
+    // Diodes enter as their small-signal model at the DC operating point.
+    mat diode_g, diode_c;
+    if (!circuit.diode_vec.empty()) {
+        const OperatingPoint& op = GetOperatingPoint();
+        if (op.converged)
+            GetDiodeSmallSignal(op, diode_g, diode_c);
+        else
+            cout << "Operating point failed, diodes are left out of AC" << endl;
+    }
+
     for (auto f : scan_freq_vec) {
         AnalysisMatrix analysis_matrix = GetAnalysisMatrix(f);
         int node_num = analysis_matrix.node_vec.size();
@@ -147,6 +334,9 @@ void Analyzer::DoAcAnalysis(const AcAnalysis ac_analysis) {
 
         cx_mat reduced_rhs = analysis_matrix.rhs(span(1, node_num - 1), 0);
 
+        if (!diode_g.is_empty())
+            reduced_mat += cx_mat(diode_g, 2 * M_PI * f * diode_c);
+
         cx_vec ac_result = arma::solve(reduced_mat, reduced_rhs);
 
         ac_result_vec.push_back(ac_result);
@@ -161,7 +351,7 @@ void Analyzer::DoAcAnalysis(const AcAnalysis ac_analysis) {
 }
 
 AnalysisMatrix Analyzer::GetAnalysisMatrix(const double frequency) {
-    const double w = M_2_PI * frequency;  // w = 2 pi f
+    const double w = 2 * M_PI * frequency;
 
     // ----- Generate NA metrix -----
     int node_num = circuit.node_vec.size();
@@ -219,23 +409,7 @@ AnalysisMatrix Analyzer::GetAnalysisMatrix(const double frequency) {
     }
 
     // Add diode
-    for (Diode diode : circuit.diode_vec) {
-        int node_1_index = FindNode(circuit.node_vec, diode.node_1);
-        int node_2_index = FindNode(circuit.node_vec, diode.node_2);
-        exp_analysis_vec.push_back(ExpTerm(node_1_index, node_1_index, node_1_index,
-                                           node_2_index, ExpCoeff(40, 40)));
-        exp_analysis_vec.push_back(ExpTerm(node_1_index, node_2_index, node_1_index,
-                                           node_2_index, ExpCoeff(-40, 40)));
-        exp_analysis_vec.push_back(ExpTerm(node_2_index, node_1_index, node_1_index,
-                                           node_2_index, ExpCoeff(-40, 40)));
-        exp_analysis_vec.push_back(ExpTerm(node_2_index, node_2_index, node_1_index,
-                                           node_2_index, ExpCoeff(40, 40)));
-
-        exp_rhs_vec.push_back(ExpTerm(node_1_index, node_1_index, node_2_index,
-                                      ExpCoeff(-1, 40, 1), ExpCoeff(40, 40)));
-        exp_rhs_vec.push_back(ExpTerm(node_2_index, node_1_index, node_2_index,
-                                      ExpCoeff(1, 40, -1), ExpCoeff(-40, 40)));
-    }
+    AddDiodeStamps(circuit, exp_analysis_vec, exp_rhs_vec);
 
     // ----- Generate MNA metrix -----
     modified_node_vec = circuit.node_vec;
@@ -20,26 +20,89 @@
 #include "qcustomplot.h"
 
 int FindNode(std::vector<NodeName> node_vec, NodeName name);
-
-void DcPlot(DcResult result, std::vector<PrintVariable> print_variable_vec);
-void AcPlot(AcResult result, std::vector<PrintVariable> print_variable_vec);
-void TranPlot(TranResult result, std::vector<PrintVariable> print_variable_vec);
+QHash<NodeName, int> GetNodeIndex(const std::vector<NodeName>& node_vec);
+DiodeModel FindDiodeModel(const Circuit& circuit, const ModelName model);
+std::vector<double> GetScanFrequencies(const AcAnalysis ac_analysis);
+double GetVsrcValue(const Vsrc vsrc, double t);
+TranAnalysisMat BackEuler(const Circuit circuit, const double h);
+
+void DcPlot(DcResult result, std::vector<PrintVariable> print_variable_vec,
+            const bool print_only = false);
+void AcPlot(AcResult result, std::vector<PrintVariable> print_variable_vec,
+            const bool print_only = false);
+void TranPlot(TranResult result, std::vector<PrintVariable> print_variable_vec,
+              const bool print_only = false);
 void Plot(std::vector<QVector<double>> x_vec, std::vector<QVector<double>> y_vec,
           std::vector<NodeName> name_vec, QString x_label, QString y_label, bool x_log,
           bool y_log);
+QString PrintLabel(const PrintVariable print_variable, const bool ac);
+void Print(std::vector<QVector<double>> x_vec, std::vector<QVector<double>> y_vec,
+           std::vector<QString> label_vec, QString x_label);
 
 arma::mat AddExpTerm(const std::vector<ExpTerm> exp_term_vec, const arma::vec result,
                      arma::mat mat);
-
-double VecDifference(arma::vec vec_old, arma::vec vec_new);
-
-const double EPSILON_ABS = 1e-5;
-const double EPSILON_REL = 1e-1;
+void AddDiodeStamps(const Circuit& circuit, std::vector<ExpTerm>& exp_analysis_vec,
+                    std::vector<ExpTerm>& exp_rhs_vec);
+
+double LimitedExp(const double x);
+
+std::vector<Junction> GetJunctions(const std::vector<ExpTerm>& exp_rhs_vec);
+double JunctionVoltage(const Junction& junction, const arma::vec& x);
+double PnjLimit(const Junction& junction, double v_new, const double v_old);
+double JunctionStepLimit(const std::vector<Junction>& junction_vec, const arma::vec& x,
+                         const arma::vec& dx);
+
+double FactorizeJacobian(const NewtonSystem& system, const arma::vec& x, LuFactor& lu,
+                         RunStatistics* stat);
+bool NewtonSolve(const NewtonSystem& system, const NewtonSetting& setting,
+                 arma::vec& result, int& iter_num);
+bool GminStepping(const NewtonSystem& system, const NewtonSetting& setting,
+                  arma::vec& result, int& iter_num);
+bool SourceStepping(const NewtonSystem& system, const NewtonSetting& setting,
+                    arma::vec& result, int& iter_num);
+bool PseudoTransient(const NewtonSystem& system, const NewtonSetting& setting,
+                     arma::vec& result, int& iter_num, PseudoTranStat& stat);
+arma::vec NewtonResidual(const NewtonSystem& system, const arma::vec& x,
+                         arma::vec* scale = nullptr);
+
+bool CheckUpdate(const arma::vec& x_old, const arma::vec& x_new, const int voltage_num,
+                 const ConvergenceCriteria& criteria);
+bool CheckResidual(const arma::vec& residual, const arma::vec& scale,
+                   const int voltage_num, const ConvergenceCriteria& criteria);
+void PrintConvergenceHistory(const ConvergenceHistory& history);
+void PrintRunStatistics(const RunStatistics& stat);
+
+std::vector<arma::uvec> PartitionUnknowns(const arma::mat& A,
+                                          const std::vector<ExpTerm>& exp_term_vec,
+                                          const double coupling);
+std::vector<ExpTerm> RestrictExpTerms(const std::vector<ExpTerm>& exp_term_vec,
+                                      const arma::uvec& index, const bool rhs);
+
+bool BuildSchurSystem(const NewtonSystem& system, SchurSystem& schur);
+void SetSchurRhs(SchurSystem& schur, const arma::mat& rhs);
+arma::vec GetSchurNonlinearPart(const SchurSystem& schur, const arma::vec& x);
+arma::vec RecoverSchurSolution(const SchurSystem& schur, const arma::vec& x_nonlinear);
+bool SolveOperatingPoint(const NewtonSystem& system, const NewtonSetting& setting,
+                         arma::vec& result, ConvergenceReport& report);
+void PrintConvergenceReport(const ConvergenceReport& report);
+
+QString CircuitHash(const Circuit& circuit);
+QString OperatingPointCachePath(const Circuit& circuit);
+
+// Damped Newton, in NewtonSolve and harmonic balance, halves its step while
+// the residual falls by less than ARMIJO_ALPHA times the step. No step, from
+// this or from the junction limits, is shorter than DAMPING_MIN.
+const double DAMPING_MIN = 1e-4;
+const double ARMIJO_ALPHA = 1e-4;
+
+// Multirate and waveform relaxation transients split blocks coupled more
+// weakly than this relative to their diagonals.
+const double MULTIRATE_COUPLING = 1e-2;
 
 class Analyzer {
   public:
     Analyzer() {}
-    Analyzer(Parser parser);
+    Analyzer(Parser parser, const bool plot = true);
     ~Analyzer() {}
 
     std::vector<AnalysisMatrix> GetAnalysisResults() { return analysis_matrix_vec; }
@@ -47,8 +110,17 @@ class Analyzer {
     void PrintMatrix(arma::cx_mat mat, std::vector<NodeName> nodes);
     void PrintRHS(arma::cx_mat rhs, std::vector<NodeName> nodes);
 
+    // What-if tuning of a linear circuit without refactorization
+    bool ChangeElementValue(const DeviceName name, const double value);
+    arma::vec SolveIncremental();
+    std::vector<NodeName> GetIncrementalNodes() { return incremental_node_vec; }
+
   private:
     Circuit circuit;
+    SimOptions options;
+    std::vector<NodeVoltage> ic_vec;
+    std::vector<NodeVoltage> nodeset_vec;
+    RunStatistics run_stat;
     std::vector<NodeName> modified_node_vec;
 
     std::vector<AnalysisMatrix> analysis_matrix_vec;
@@ -56,12 +128,67 @@ class Analyzer {
     TranResult tran_result;
     DcResult dc_result;
     AcResult ac_result;
+    SensResult sens_result;
+    TfResult tf_result;
+    PzResult pz_result;
+    NoiseResult noise_result;
+    HbResult hb_result;
+
+    bool operating_point_ready = false;
+    OperatingPoint operating_point;
 
     void DoDcAnalysis(const DcAnalysis dc_analysis);
+    void DoOpAnalysis(const std::vector<PrintVariable> print_variable_vec);
     void DoAcAnalysis(const AcAnalysis ac_analysis);
     void DoTranAnalysis(const TranAnalysis tran_analysis);
+    void DoExpTranAnalysis(const TranAnalysis tran_analysis);
+    void DoMultirateTranAnalysis(const TranAnalysis tran_analysis);
+    bool DoWrTranAnalysis(const TranAnalysis tran_analysis);
+    void DoPararealTranAnalysis(const TranAnalysis tran_analysis);
+    void DoFaultAnalysis(const FaultAnalysis fault_analysis,
+                         const std::vector<PrintVariable> print_variable_vec);
+
+    void DoSensAnalysis(const SensAnalysis sens_analysis);
+    void DoTfAnalysis(const TfAnalysis tf_analysis);
+    void DoPzAnalysis(const PzAnalysis pz_analysis);
+    void DoNoiseAnalysis(const NoiseAnalysis noise_analysis);
+    void DoHbAnalysis(const HbAnalysis hb_analysis,
+                      const std::vector<PrintVariable> print_variable_vec);
+    void DoPssAnalysis(const PssAnalysis pss_analysis);
+
+    bool InitTranStepper(const double h, TranStepper& stepper);
+    bool TranStep(TranStepper& stepper, const double t, const arma::vec& x_prev,
+                  arma::vec& x_next, int& iter_num);
+    arma::vec GetTranInitialState(const TranAnalysis tran_analysis,
+                                  const std::vector<NodeName>& node_vec);
+
+    std::vector<Fault> GetFaults(const FaultAnalysis fault_analysis);
+    const OperatingPoint& GetOperatingPoint();
+    void SeedNodeset(NewtonSystem system, arma::vec& result);
+    bool LoadOperatingPoint(const std::vector<NodeName>& node_vec, arma::vec& result);
+    void SaveOperatingPoint(const std::vector<NodeName>& node_vec,
+                            const arma::vec& result);
+    void GetDiodeSmallSignal(const OperatingPoint& op, arma::mat& diode_g,
+                             arma::mat& diode_c);
+    bool GetTransferStamps(const TfAnalysis tf_analysis,
+                           const QHash<NodeName, int>& node_index, arma::vec& c,
+                           arma::vec& u);
+    void GetLinearPencil(arma::mat& G, arma::mat& C, std::vector<NodeName>& node_vec,
+                         std::vector<Junction>& junction_vec);
+    bool GetPencil(arma::mat& G, arma::mat& C, QHash<NodeName, int>& node_index);
 
     AnalysisMatrix GetAnalysisMatrix(const double frequency);
+
+    // State of the incremental solver, built on the first element change
+    bool incremental_ready = false;
+    LowRankSolver low_rank_solver;
+    arma::vec incremental_rhs;
+    std::vector<NodeName> incremental_node_vec;
+
+    bool InitIncremental();
+    void DoAlterAnalysis(const std::vector<ElementChange>& alter_vec);
+    int ReducedIndex(const NodeName node);
+    arma::vec UnitVec(const int index_1, const int index_2);
 };
 
 #endif  // ANALYZER_H
@@ -0,0 +1,80 @@
+/**
+ * @file analyzer_breakpoint.cpp
+ * @brief Lazily generated source breakpoints
+ * @date 2026-10-19
+ */
+
+#include <limits>
+
+#include "analyzer.h"
+
+/**
+ * @brief Queue the first corner after t_start of every Pulse and Sin source:
+ * td, td + tr, td + tr + pw and td + tr + pw + tf of each pulse period, and
+ * the onset td of a sine.
+ *
+ * @param vsrc_vec
+ * @param t_start
+ */
+void BreakpointQueue::Init(const std::vector<Vsrc>& vsrc_vec, const double t_start) {
+    source_vec.clear();
+    queue = decltype(queue)();
+
+    for (Vsrc vsrc : vsrc_vec) {
+        SourceCorners corners;
+        if (vsrc.pulse.chosen) {
+            const Pulse& pulse = vsrc.pulse;
+            corners.offset_vec = {0, pulse.tr, pulse.tr + pulse.pw,
+                                  pulse.tr + pulse.pw + pulse.tf};
+            corners.td = pulse.td;
+            corners.per = pulse.per >= corners.offset_vec.back() ? pulse.per : 0;
+            // Without a gap the end of the fall is the start of the next period.
+            if (corners.per > 0 && corners.per == corners.offset_vec.back())
+                corners.offset_vec.pop_back();
+        } else if (vsrc.sin.chosen) {
+            corners.offset_vec = {0};
+            corners.td = vsrc.sin.td;
+            corners.per = 0;
+        } else
+            continue;
+
+        // Jump straight to the period holding t_start.
+        if (corners.per > 0 && t_start > corners.td)
+            corners.period = floor((t_start - corners.td) / corners.per);
+        while (corners.period >= 0 && corners.Time() <= t_start) {
+            if (++corners.corner == static_cast<int>(corners.offset_vec.size())) {
+                corners.corner = 0;
+                corners.period = corners.per > 0 ? corners.period + 1 : -1;
+            }
+        }
+        if (corners.period < 0)
+            continue;
+        source_vec.push_back(corners);
+        queue.push({corners.Time(), source_vec.size() - 1});
+    }
+}
+
+/**
+ * @brief The first breakpoint later than t + tol, infinity if none. The
+ * breakpoints up to t + tol are dropped, so t must not decrease between calls.
+ *
+ * @param t
+ * @param tol
+ * @return double
+ */
+double BreakpointQueue::NextAfter(const double t, const double tol) {
+    while (!queue.empty() && queue.top().first <= t + tol) {
+        int index = queue.top().second;
+        queue.pop();
+
+        SourceCorners& corners = source_vec[index];
+        if (++corners.corner == static_cast<int>(corners.offset_vec.size())) {
+            if (corners.per <= 0)
+                continue;
+            corners.corner = 0;
+            corners.period++;
+        }
+        queue.push({corners.Time(), index});
+    }
+    return queue.empty() ? std::numeric_limits<double>::infinity() : queue.top().first;
+}
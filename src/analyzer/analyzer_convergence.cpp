@@ -0,0 +1,66 @@
+/**
+ * @file analyzer_convergence.cpp
+ * @brief Convergence criteria of the Newton iteration
+ * @date 2026-10-19
+ */
+
+#include "analyzer.h"
+
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::setw;
+
+/**
+ * @brief Check the Newton update. Node voltages use vntol, branch currents
+ * use abstol, both on top of reltol of the larger of the two iterates.
+ *
+ * @param x_old
+ * @param x_new
+ * @param voltage_num the first `voltage_num` unknowns are node voltages
+ * @param criteria
+ * @return true: every unknown is within its tolerance
+ */
+bool CheckUpdate(const vec& x_old, const vec& x_new, const int voltage_num,
+                 const ConvergenceCriteria& criteria) {
+    const int size = x_old.n_elem;
+    for (int i = 0; i < size; i++) {
+        double tol = criteria.reltol * std::max(fabs(x_old(i)), fabs(x_new(i))) +
+                     (i < voltage_num ? criteria.vntol : criteria.abstol);
+        if (fabs(x_new(i) - x_old(i)) > tol)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Check the residual. KCL rows are currents and are compared against
+ * abstol, branch rows are voltages and are compared against vntol. `scale`
+ * holds the magnitude of the terms summed into each row.
+ *
+ * @param residual
+ * @param scale
+ * @param voltage_num
+ * @param criteria
+ * @return true: every equation is satisfied within its tolerance
+ */
+bool CheckResidual(const vec& residual, const vec& scale, const int voltage_num,
+                   const ConvergenceCriteria& criteria) {
+    const int size = residual.n_elem;
+    for (int i = 0; i < size; i++) {
+        double tol = criteria.reltol * scale(i) +
+                     (i < voltage_num ? criteria.abstol : criteria.vntol);
+        if (fabs(residual(i)) > tol)
+            return false;
+    }
+    return true;
+}
+
+void PrintConvergenceHistory(const ConvergenceHistory& history) {
+    cout << "  " << setw(6) << "iter" << setw(14) << "|dx|" << setw(14) << "|F|"
+         << setw(10) << "damping" << setw(10) << "refactor" << endl;
+    for (std::size_t i = 0; i < history.size(); i++)
+        cout << "  " << setw(6) << i + 1 << setw(14) << history[i].update_norm
+             << setw(14) << history[i].residual_norm << setw(10) << history[i].damping
+             << setw(10) << history[i].refactor_fraction << endl;
+}
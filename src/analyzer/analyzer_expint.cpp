@@ -0,0 +1,202 @@
+/**
+ * @file analyzer_expint.cpp
+ * @brief Exponential integrator for linear transient analysis
+ * @date 2026-10-19
+ */
+
+#include <algorithm>
+
+#include "analyzer.h"
+
+using arma::cx_mat;
+using arma::cx_vec;
+using arma::mat;
+using arma::span;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::vector;
+
+// Krylov space limit and relative tolerance of the exponential integrator. A
+// segment that needs more vectors is halved at most EXPINT_MAX_HALVING times.
+// Ritz values of T below EXPINT_MU_MIN are the algebraic part and are dropped.
+constexpr int EXPINT_KRYLOV_DIM = 30;
+constexpr double EXPINT_TOL = 1e-9;
+constexpr int EXPINT_MAX_HALVING = 20;
+constexpr double EXPINT_MU_MIN = 1e-10;
+
+/**
+ * @brief Eigen-decomposition of the Arnoldi matrix H of T, so that
+ * exp(tau * A_m) * e_1 = W * (e^{tau * rate} % coeff) for the projected
+ * A_m = (I - H^{-1}) / gamma. A Ritz value mu near 0 belongs to the algebraic
+ * part of the system, where C is singular, and its mode decays at once. It is
+ * dropped instead of inverted, so a resistive circuit does not overflow.
+ */
+static void DecomposeKrylov(const mat& H_m, const double gamma, cx_mat& W, cx_vec& rate,
+                            cx_vec& coeff) {
+    const int m = H_m.n_rows;
+    cx_vec mu;
+    if (!arma::eig_gen(mu, W, H_m)) {
+        W = arma::eye<cx_mat>(m, m);
+        mu = arma::conv_to<cx_vec>::from(H_m.diag());
+    }
+    cx_vec e_1(m, arma::fill::zeros);
+    e_1(0) = 1;
+    if (!arma::solve(coeff, W, e_1))
+        coeff = arma::pinv(W) * e_1;
+
+    rate.zeros(m);
+    for (int i = 0; i < m; i++) {
+        if (std::abs(mu(i)) < EXPINT_MU_MIN)
+            coeff(i) = 0;
+        else
+            rate(i) = (1.0 - 1.0 / mu(i)) / gamma;
+    }
+}
+
+/**
+ * @brief Linear transient of C * x' + G * x = b(t) by an exponential
+ * integrator. Between two source breakpoints b(t) is linear, so
+ * x(t) = p + q * (t - t_a) + e^{(t - t_a) A} * (x_a - p) exactly, with
+ * G * q = b', G * p = b(t_a) - C * q and A the pencil operator -C^{-1} * G.
+ * The exponential is taken in the invert Krylov space of
+ * T = (C + gamma * G)^{-1} * C, whose eigenvalues mu = 1 / (1 - gamma * lambda)
+ * stay bounded even though C is singular. One Krylov space per segment
+ * serves every output point inside it, so the step count is set by the
+ * breakpoints from BreakpointQueue, not by the stiffness. A segment over which
+ * EXPINT_KRYLOV_DIM vectors do not reach EXPINT_TOL is halved until they do.
+ *
+ * @param tran_analysis
+ */
+void Analyzer::DoExpTranAnalysis(const TranAnalysis tran_analysis) {
+    const double t_start = tran_analysis.t_start;
+    const double t_stop = tran_analysis.t_stop;
+    const double t_step = tran_analysis.t_step;
+    const int scan_num = (t_stop - t_start) / t_step;
+
+    mat G, C;
+    vector<NodeName> node_vec;
+    vector<Junction> junction_vec;
+    GetLinearPencil(G, C, node_vec, junction_vec);
+    const int size = G.n_rows;
+
+    const double gamma = t_step;
+    LuFactor g_lu, shift_lu;
+    if (!g_lu.Factorize(G) || !shift_lu.Factorize(mat(C + gamma * G))) {
+        cout << "Exponential integrator: singular G, no transient" << endl;
+        return;
+    }
+    run_stat.factorization_num += 2;
+
+    SourceTable source_table;
+    source_table.Build(circuit, node_vec);
+    auto source = [&](double t) {
+        vec b(size, arma::fill::zeros);
+        source_table.Apply(t, b);
+        return b;
+    };
+
+    vector<double> time_point_vec;
+    for (int i = 0; i <= scan_num; i++)
+        time_point_vec.push_back(t_start + i * t_step);
+
+    BreakpointQueue breakpoint_queue;
+    breakpoint_queue.Init(circuit.vsrc_vec, t_start);
+    bool has_sin = false;
+    for (Vsrc vsrc : circuit.vsrc_vec)
+        has_sin = has_sin || vsrc.sin.chosen;
+
+    mat tran_result_mat(size, scan_num + 1, arma::fill::zeros);
+    tran_result_mat.col(0) = GetTranInitialState(tran_analysis, node_vec);
+    vec x = tran_result_mat.col(0);
+    const double t_end = time_point_vec.back();
+    const double tol = 1e-9 * t_step;
+    double t_a = t_start;
+    int output = 1, segment_num = 0, krylov_sum = 0, split_num = 0, unsettled_num = 0;
+    while (t_a < t_end - tol) {
+        // A sine is only piecewise linear on the output grid.
+        double t_b = std::min(breakpoint_queue.NextAfter(t_a, tol), t_end);
+        if (has_sin)
+            t_b = std::min(t_b, time_point_vec[output]);
+        double length = t_b - t_a;
+        segment_num++;
+
+        vec b_a = source(t_a);
+        vec q = g_lu.Solve(vec((source(t_b) - b_a) / length));
+        vec p = g_lu.Solve(vec(b_a - C * q));
+        vec v = x - p;
+        double beta = arma::norm(v);
+        run_stat.solve_num += 2;
+
+        // Arnoldi on T until the exponential over the whole segment settles
+        mat V(size, EXPINT_KRYLOV_DIM + 1, arma::fill::zeros);
+        mat H(EXPINT_KRYLOV_DIM + 1, EXPINT_KRYLOV_DIM, arma::fill::zeros);
+        cx_mat W;
+        cx_vec rate, coeff;
+        auto krylov_exp = [&](double tau) {
+            return vec(arma::real(W * (arma::exp(tau * rate) % coeff)));
+        };
+        const double error_tol = EXPINT_TOL * std::max(beta, arma::norm(p));
+        int m = 0;
+        // Error of the exponential over tau from the part left out of the space
+        auto krylov_error = [&](double tau) {
+            return beta * H(m, m - 1) * fabs(krylov_exp(tau)(m - 1));
+        };
+        bool settled = true;
+        if (beta > 0) {
+            V.col(0) = v / beta;
+            for (int j = 0; j < EXPINT_KRYLOV_DIM; j++) {
+                vec w = shift_lu.Solve(vec(C * V.col(j)));
+                run_stat.solve_num++;
+                for (int i = 0; i <= j; i++) {
+                    H(i, j) = arma::dot(V.col(i), w);
+                    w -= H(i, j) * V.col(i);
+                }
+                H(j + 1, j) = arma::norm(w);
+                m = j + 1;
+
+                DecomposeKrylov(H(span(0, j), span(0, j)), gamma, W, rate, coeff);
+                settled = H(j + 1, j) < 1e-12 || krylov_error(length) < error_tol;
+                if (settled)
+                    break;
+                V.col(j + 1) = w / H(j + 1, j);
+            }
+        }
+
+        // The full space does not settle over the segment: take a shorter one.
+        // p and q stay valid, b(t) is linear over all of it.
+        if (!settled) {
+            int halving_num = 0;
+            double sub_length = length;
+            while (krylov_error(sub_length) >= error_tol &&
+                   halving_num < EXPINT_MAX_HALVING) {
+                sub_length /= 2;
+                halving_num++;
+            }
+            if (krylov_error(sub_length) >= error_tol)
+                unsettled_num++;
+            length = sub_length;
+            t_b = t_a + length;
+            split_num++;
+        }
+        krylov_sum += m;
+
+        auto state_at = [&](double tau) {
+            vec x_t = p + tau * q;
+            if (m > 0)
+                x_t += beta * V.cols(0, m - 1) * krylov_exp(tau);
+            return x_t;
+        };
+        for (; output <= scan_num && time_point_vec[output] <= t_b + tol; output++)
+            tran_result_mat.col(output) = state_at(time_point_vec[output] - t_a);
+        x = state_at(length);
+        t_a = t_b;
+    }
+
+    cout << "Exponential integrator: " << segment_num << " segments (" << split_num
+         << " shortened), " << krylov_sum << " Krylov vectors" << endl;
+    if (unsettled_num > 0)
+        cout << "Warning: " << unsettled_num << " segments did not reach the Krylov "
+             << "tolerance " << EXPINT_TOL << endl;
+    tran_result = TranResult{tran_result_mat, time_point_vec, node_vec};
+}
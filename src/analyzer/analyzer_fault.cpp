@@ -0,0 +1,240 @@
+/**
+ * @file analyzer_fault.cpp
+ * @brief Single-fault DC simulation on top of the nominal factorization
+ * @date 2026-10-19
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include "analyzer.h"
+
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::setw;
+using std::vector;
+
+// Open and short faults are modelled as these resistances so that the faulty
+// circuit stays nonsingular.
+constexpr double FAULT_R_OPEN = 1e9;
+constexpr double FAULT_R_SHORT = 1e-3;
+
+// An output detects a fault once it moves by more than this from nominal.
+constexpr double FAULT_ABS_TOL = 1e-3;
+constexpr double FAULT_REL_TOL = 1e-2;
+
+/**
+ * @brief Solve one fault with the Sherman-Morrison formula:
+ * x = y - z * (v^T y) / (1 + v^T z), y = A^{-1} (b + delta_rhs), z = A^{-1} u
+ */
+static FaultResult SolveFault(const LuFactor& lu, const vec& nominal,
+                              const Fault& fault) {
+    FaultResult fault_result;
+    vec y = nominal;
+    if (!fault.delta_rhs.is_empty())
+        y += lu.Solve(fault.delta_rhs);
+
+    if (!fault.u.is_empty()) {
+        vec z = lu.Solve(fault.u);
+        double denominator = 1 + arma::dot(fault.v, z);
+        if (fabs(denominator) < 1e-12 || !std::isfinite(denominator))
+            return fault_result;
+        y -= z * (arma::dot(fault.v, y) / denominator);
+    }
+
+    fault_result.solved = y.is_finite();
+    fault_result.result = y;
+    return fault_result;
+}
+
+/**
+ * @brief Enumerate the single faults of the chosen devices as rank-1 changes
+ * of the nominal DC system: resistors open and short, capacitors short,
+ * inductors open, independent and dependent sources stuck at 0.
+ */
+vector<Fault> Analyzer::GetFaults(const FaultAnalysis fault_analysis) {
+    const vector<DeviceName>& device_vec = fault_analysis.device_vec;
+    auto chosen = [&device_vec](DeviceName name) {
+        return device_vec.empty() ||
+               std::find(device_vec.begin(), device_vec.end(), name) != device_vec.end();
+    };
+
+    vector<Fault> fault_vec;
+    for (Res res : circuit.res_vec) {
+        if (!chosen(res.name))
+            continue;
+        vec u = UnitVec(ReducedIndex(res.node_1), ReducedIndex(res.node_2));
+        Fault open(res.name, OPEN), shorted(res.name, SHORT);
+        open.u = shorted.u = u;
+        open.v = (1 / FAULT_R_OPEN - 1 / res.value) * u;
+        shorted.v = (1 / FAULT_R_SHORT - 1 / res.value) * u;
+        fault_vec.push_back(open);
+        fault_vec.push_back(shorted);
+    }
+
+    // A capacitor is already open at DC.
+    for (Cap cap : circuit.cap_vec) {
+        if (!chosen(cap.name))
+            continue;
+        Fault shorted(cap.name, SHORT);
+        shorted.u = UnitVec(ReducedIndex(cap.node_1), ReducedIndex(cap.node_2));
+        shorted.v = shorted.u / FAULT_R_SHORT;
+        fault_vec.push_back(shorted);
+    }
+
+    // An inductor is already shorted at DC. Open replaces its branch equation
+    // V(node_1) - V(node_2) = 0 by i = 0.
+    for (Ind ind : circuit.ind_vec) {
+        if (!chosen(ind.name))
+            continue;
+        int branch_index = ReducedIndex("i_" + ind.name);
+        Fault open(ind.name, OPEN);
+        open.u = UnitVec(branch_index, -1);
+        open.v = UnitVec(branch_index, -1) -
+                 UnitVec(ReducedIndex(ind.node_1), ReducedIndex(ind.node_2));
+        fault_vec.push_back(open);
+    }
+
+    for (Vsrc vsrc : circuit.vsrc_vec) {
+        if (!chosen(vsrc.name))
+            continue;
+        Fault stuck(vsrc.name, STUCK);
+        stuck.delta_rhs = -1 * vsrc.value * UnitVec(ReducedIndex("i_" + vsrc.name), -1);
+        fault_vec.push_back(stuck);
+    }
+
+    for (Isrc isrc : circuit.isrc_vec) {
+        if (!chosen(isrc.name))
+            continue;
+        Fault stuck(isrc.name, STUCK);
+        vec u = UnitVec(ReducedIndex(isrc.node_1), ReducedIndex(isrc.node_2));
+        stuck.delta_rhs = -1 * isrc.value * u;
+        fault_vec.push_back(stuck);
+    }
+
+    for (VCCS vccs : circuit.vccs_vec) {
+        if (!chosen(vccs.name))
+            continue;
+        Fault stuck(vccs.name, STUCK);
+        stuck.u = UnitVec(ReducedIndex(vccs.node_1), ReducedIndex(vccs.node_2));
+        stuck.v = -1 * vccs.value *
+                  UnitVec(ReducedIndex(vccs.ctrl_node_1), ReducedIndex(vccs.ctrl_node_2));
+        fault_vec.push_back(stuck);
+    }
+
+    for (VCVS vcvs : circuit.vcvs_vec) {
+        if (!chosen(vcvs.name))
+            continue;
+        Fault stuck(vcvs.name, STUCK);
+        stuck.u = UnitVec(ReducedIndex("i_" + vcvs.name), -1);
+        stuck.v = vcvs.value *
+                  UnitVec(ReducedIndex(vcvs.ctrl_node_1), ReducedIndex(vcvs.ctrl_node_2));
+        fault_vec.push_back(stuck);
+    }
+
+    return fault_vec;
+}
+
+/**
+ * @brief Factorize the nominal DC system once and evaluate every single fault
+ * as a rank-1 perturbation of it, spread over the hardware threads. Prints
+ * the faulty value of each printed output and whether it detects the fault.
+ *
+ * @param fault_analysis
+ * @param print_variable_vec the observed outputs; every node if empty
+ */
+void Analyzer::DoFaultAnalysis(const FaultAnalysis fault_analysis,
+                               const vector<PrintVariable> print_variable_vec) {
+    if (!circuit.diode_vec.empty()) {
+        cout << "Fault analysis only supports linear circuits" << endl;
+        return;
+    }
+
+    if (!InitIncremental())
+        return;
+    const LuFactor& lu = low_rank_solver.lu;
+    vec nominal = lu.Solve(incremental_rhs);
+
+    vector<NodeName> output_vec;
+    vector<int> output_index_vec;
+    for (PrintVariable print_variable : print_variable_vec) {
+        int index = ReducedIndex(print_variable.node);
+        if (print_variable.print_i_v == V && index >= 0) {
+            output_vec.push_back(print_variable.node);
+            output_index_vec.push_back(index);
+        }
+    }
+    if (output_vec.empty()) {
+        for (std::size_t i = 0; i + 1 < circuit.node_vec.size(); i++) {
+            output_vec.push_back(incremental_node_vec[i]);
+            output_index_vec.push_back(i);
+        }
+    }
+
+    vector<Fault> fault_vec = GetFaults(fault_analysis);
+    const int fault_num = fault_vec.size();
+    vector<FaultResult> fault_result_vec(fault_num);
+
+    auto worker = [&](int first, int stride) {
+        for (int i = first; i < fault_num; i += stride) {
+            FaultResult fault_result = SolveFault(lu, nominal, fault_vec[i]);
+            for (int index : output_index_vec) {
+                double delta = fault_result.solved
+                                   ? fabs(fault_result.result(index) - nominal(index))
+                                   : 0;
+                fault_result.detected_vec.push_back(
+                    fault_result.solved &&
+                    delta > FAULT_ABS_TOL + FAULT_REL_TOL * fabs(nominal(index)));
+            }
+            fault_result_vec[i] = fault_result;
+        }
+    };
+
+    int thread_num = std::max(1u, std::thread::hardware_concurrency());
+    thread_num = std::min(thread_num, std::max(fault_num, 1));
+    vector<std::thread> thread_vec;
+    for (int t = 1; t < thread_num; t++)
+        thread_vec.push_back(std::thread(worker, t, thread_num));
+    worker(0, thread_num);
+    for (std::thread& thread : thread_vec)
+        thread.join();
+
+    // ----- Detectability table -----
+    cout << "Fault analysis: " << fault_num << " faults on " << thread_num
+         << " threads" << endl;
+    // Each output shows its faulty value, marked x where it detects the fault.
+    cout << setw(10) << "device" << setw(12) << "fault";
+    for (NodeName output : output_vec)
+        cout << setw(12) << "v(" + output + ")" << "  ";
+    cout << setw(10) << "detected" << endl;
+    cout << setw(10) << "nominal" << setw(12) << "";
+    for (int index : output_index_vec)
+        cout << setw(12) << nominal(index) << "  ";
+    cout << endl;
+
+    int detected_num = 0;
+    for (int i = 0; i < fault_num; i++) {
+        const FaultResult& fault_result = fault_result_vec[i];
+        cout << setw(10) << fault_vec[i].name << setw(12)
+             << FaultType_lookup[fault_vec[i].type];
+        bool detected = false;
+        for (std::size_t k = 0; k < output_index_vec.size(); k++) {
+            if (!fault_result.solved) {
+                cout << setw(12) << "-" << "  ";
+                continue;
+            }
+            bool output_detected = fault_result.detected_vec[k];
+            cout << setw(12) << fault_result.result(output_index_vec[k])
+                 << (output_detected ? " x" : " .");
+            detected = detected || output_detected;
+        }
+        cout << setw(10) << (fault_result.solved ? (detected ? "yes" : "no") : "singular")
+             << endl;
+        if (detected)
+            detected_num++;
+    }
+    if (fault_num > 0)
+        cout << "Fault coverage: " << detected_num << " / " << fault_num << " ("
+             << 100.0 * detected_num / fault_num << "%)" << endl;
+}
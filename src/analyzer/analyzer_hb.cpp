@@ -0,0 +1,346 @@
+/**
+ * @file analyzer_hb.cpp
+ * @brief Harmonic balance for the periodic steady state
+ * @date 2026-10-19
+ */
+
+#include <functional>
+
+#include "analyzer.h"
+
+using arma::cx_double;
+using arma::cx_mat;
+using arma::cx_vec;
+using arma::mat;
+using arma::span;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::setw;
+using std::vector;
+
+// Harmonic balance solves each Newton step with full (unrestarted) GMRES and
+// samples the diodes HB_OVERSAMPLE times as often as the harmonics need.
+constexpr int HB_GMRES_DIM = 100;
+constexpr double HB_GMRES_TOL = 1e-8;
+constexpr int HB_OVERSAMPLE = 2;
+
+typedef std::function<cx_vec(const cx_vec&)> LinearOperator;
+
+/**
+ * @brief GMRES with right preconditioning, solving A * M^{-1} * y = b and
+ * returning x = M^{-1} * y. The Hessenberg matrix is reduced by Givens
+ * rotations as it grows, so the residual is known at every step without a
+ * least-squares solve. Stops at a relative residual of `tol` or after
+ * `max_dim` Krylov vectors.
+ */
+static cx_vec Gmres(const LinearOperator& A, const LinearOperator& M_inv, const cx_vec& b,
+                    const int max_dim, const double tol, int& iter_num) {
+    const int n = b.n_elem;
+    const double beta = arma::norm(b);
+    iter_num = 0;
+    if (beta == 0)
+        return cx_vec(n, arma::fill::zeros);
+
+    cx_mat V(n, max_dim + 1, arma::fill::zeros);
+    cx_mat R(max_dim, max_dim, arma::fill::zeros);  // H after the rotations
+    vec cs(max_dim, arma::fill::zeros);
+    cx_vec sn(max_dim, arma::fill::zeros);
+    cx_vec g(max_dim + 1, arma::fill::zeros);  // beta * e_1 after the rotations
+    g(0) = beta;
+    V.col(0) = b / beta;
+
+    for (int j = 0; j < max_dim; j++) {
+        iter_num = j + 1;
+        cx_vec w = A(M_inv(V.col(j)));
+        for (int i = 0; i <= j; i++) {
+            R(i, j) = arma::cdot(V.col(i), w);
+            w -= R(i, j) * V.col(i);
+        }
+        const double h_next = arma::norm(w);
+
+        // The earlier rotations on the new column, then a new one for h_next
+        for (int i = 0; i < j; i++) {
+            cx_double r_i = cs(i) * R(i, j) + sn(i) * R(i + 1, j);
+            R(i + 1, j) = -std::conj(sn(i)) * R(i, j) + cs(i) * R(i + 1, j);
+            R(i, j) = r_i;
+        }
+        const double a = std::abs(R(j, j));
+        const double rho = std::hypot(a, h_next);
+        cs(j) = a == 0 ? 0 : a / rho;
+        sn(j) = a == 0 ? cx_double(1) : R(j, j) / a * (h_next / rho);
+        R(j, j) = cs(j) * R(j, j) + sn(j) * h_next;
+        g(j + 1) = -std::conj(sn(j)) * g(j);
+        g(j) = cs(j) * g(j);
+
+        if (std::abs(g(j + 1)) <= tol * beta || h_next < 1e-14 * beta)
+            break;
+        V.col(j + 1) = w / h_next;
+    }
+
+    const int m = iter_num;
+    cx_vec y = arma::solve(arma::trimatu(R(span(0, m - 1), span(0, m - 1))), g.head(m));
+    return M_inv(V.cols(0, m - 1) * y);
+}
+
+/**
+ * @brief Periodic steady state with fundamental f0 by harmonic balance. The
+ * unknowns are the Fourier coefficients X_k of all MNA unknowns at
+ * N = 2 * nharm + 1 frequencies. Each Newton step solves
+ * (G + j k w0 C) dX_k + FFT(g(t) * IFFT(dX))_k = -R_k with GMRES: the linear
+ * part is applied per harmonic and the diodes in the time domain, and each
+ * harmonic is preconditioned by the LU of G + j k w0 C + mean(g). The diodes
+ * are evaluated at HB_OVERSAMPLE * N samples, so the harmonics they produce
+ * above nharm do not fold back onto the kept ones. The step is limited at
+ * the junctions and then halved until the residual decreases.
+ *
+ * @param hb_analysis
+ * @param print_variable_vec printed nodes; every node if empty
+ */
+void Analyzer::DoHbAnalysis(const HbAnalysis hb_analysis,
+                            const vector<PrintVariable> print_variable_vec) {
+    mat G, C;
+    vector<NodeName> node_vec;
+    vector<Junction> junction_vec;
+    GetLinearPencil(G, C, node_vec, junction_vec);
+    QHash<NodeName, int> node_index = GetNodeIndex(node_vec);
+
+    const int size = G.n_rows;
+    const int harmonic_num = hb_analysis.harmonic_num;
+    const int N = 2 * harmonic_num + 1;
+    const int M = HB_OVERSAMPLE * N;
+    const double w0 = 2 * M_PI * hb_analysis.f0;
+    const double period = 1 / hb_analysis.f0;
+    const int voltage_num = circuit.node_vec.size() - 1;
+    auto harmonic = [N, harmonic_num](int k) { return k <= harmonic_num ? k : k - N; };
+
+    // Samples in the rows, unknowns in the columns: X_t(n, :) = x(n * T / M).
+    // X_f holds the Fourier coefficients of harmonics 0..nharm, then
+    // -nharm..-1, as FFT(X_t) / M without the harmonics above nharm.
+    auto to_freq = [M, harmonic_num](const cx_mat& X_t) {
+        cx_mat F = arma::fft(X_t) / M;
+        return cx_mat(arma::join_cols(F.rows(0, harmonic_num),
+                                      F.rows(M - harmonic_num, M - 1)));
+    };
+    auto to_time = [M, N, harmonic_num](const cx_mat& X_f) {
+        cx_mat F(M, X_f.n_cols, arma::fill::zeros);
+        F.rows(0, harmonic_num) = X_f.rows(0, harmonic_num);
+        F.rows(M - harmonic_num, M - 1) = X_f.rows(harmonic_num + 1, N - 1);
+        return cx_mat(arma::ifft(F) * M);
+    };
+
+    // Source excitation
+    mat B_t(M, size, arma::fill::zeros);
+    for (int n = 0; n < M; n++) {
+        double t = n * period / M;
+        for (Vsrc vsrc : circuit.vsrc_vec)
+            B_t(n, node_index.value("i_" + vsrc.name)) = GetVsrcValue(vsrc, t);
+        for (Isrc isrc : circuit.isrc_vec) {
+            int index_1 = node_index.value(isrc.node_1, -1);
+            int index_2 = node_index.value(isrc.node_2, -1);
+            if (index_1 >= 0)
+                B_t(n, index_1) += isrc.value;
+            if (index_2 >= 0)
+                B_t(n, index_2) -= isrc.value;
+        }
+    }
+    const cx_mat B_f = to_freq(arma::conv_to<cx_mat>::from(B_t));
+
+    vector<cx_mat> Y_vec;
+    for (int k = 0; k < N; k++)
+        Y_vec.push_back(cx_mat(G, harmonic(k) * w0 * C));
+    auto apply_linear = [&](const cx_mat& X_f) {
+        cx_mat out(N, size);
+        for (int k = 0; k < N; k++)
+            out.row(k) = (Y_vec[k] * X_f.row(k).st()).st();
+        return out;
+    };
+
+    // Diode currents I_f and conductances g_t at the samples of X_f
+    auto apply_diode_current = [&](const cx_mat& X_f, cx_mat& I_f, mat& g_t) {
+        mat X_t = arma::real(to_time(X_f));
+        mat I_t(M, size, arma::fill::zeros);
+        g_t.set_size(M, junction_vec.size());
+        for (std::size_t d = 0; d < junction_vec.size(); d++) {
+            const Junction& junction = junction_vec[d];
+            for (int n = 0; n < M; n++) {
+                double v = JunctionVoltage(junction, X_t.row(n).t());
+                double e = LimitedExp(v / junction.vt);
+                double i_d = junction.i_sat * (e - 1);
+                g_t(n, d) = junction.i_sat / junction.vt * e;
+                if (junction.node_1_index >= 0)
+                    I_t(n, junction.node_1_index) += i_d;
+                if (junction.node_2_index >= 0)
+                    I_t(n, junction.node_2_index) -= i_d;
+            }
+        }
+        I_f = to_freq(arma::conv_to<cx_mat>::from(I_t));
+    };
+
+    // Every harmonic of the residual within its tolerance, as in NewtonSolve
+    NewtonSetting newton_setting(options);
+    auto check_residual = [&](const cx_mat& X_f, const cx_mat& I_f, const cx_mat& R_f) {
+        for (int k = 0; k < N; k++) {
+            vec scale = arma::abs(Y_vec[k]) * vec(arma::abs(X_f.row(k).st())) +
+                        vec(arma::abs(I_f.row(k).st())) + vec(arma::abs(B_f.row(k).st()));
+            if (!CheckResidual(vec(arma::abs(R_f.row(k).st())), scale, voltage_num,
+                               newton_setting.criteria))
+                return false;
+        }
+        return true;
+    };
+
+    // Start from the DC operating point in every sample.
+    mat X_t(M, size, arma::fill::zeros);
+    const OperatingPoint& op = GetOperatingPoint();
+    if (op.converged && static_cast<int>(op.result.n_elem) == size)
+        X_t.each_row() = op.result.t();
+    cx_mat X_f = to_freq(arma::conv_to<cx_mat>::from(X_t));
+
+    cx_mat I_f;
+    mat g_t;
+    apply_diode_current(X_f, I_f, g_t);
+    cx_mat R_f = apply_linear(X_f) + I_f - B_f;
+    double residual_n = arma::norm(R_f, "fro");
+
+    bool converged = false;
+    int iter_num = 0, gmres_iter_sum = 0;
+    for (iter_num = 1; iter_num <= newton_setting.max_iter; iter_num++) {
+        // Jacobian-vector product, diodes applied sample by sample
+        auto apply_diode = [&](const cx_mat& dX_t) {
+            cx_mat dI_t(M, size, arma::fill::zeros);
+            for (std::size_t d = 0; d < junction_vec.size(); d++) {
+                int index_1 = junction_vec[d].node_1_index;
+                int index_2 = junction_vec[d].node_2_index;
+                cx_vec dv(M, arma::fill::zeros);
+                if (index_1 >= 0)
+                    dv += dX_t.col(index_1);
+                if (index_2 >= 0)
+                    dv -= dX_t.col(index_2);
+                cx_vec di = dv % g_t.col(d);
+                if (index_1 >= 0)
+                    dI_t.col(index_1) += di;
+                if (index_2 >= 0)
+                    dI_t.col(index_2) -= di;
+            }
+            return dI_t;
+        };
+        LinearOperator jacobian = [&](const cx_vec& v) {
+            cx_mat dX_f = arma::reshape(v, N, size);
+            cx_mat JdX = apply_linear(dX_f) + to_freq(apply_diode(to_time(dX_f)));
+            return cx_vec(arma::vectorise(JdX));
+        };
+
+        // Block-diagonal preconditioner with the average diode conductance
+        mat D_avg(size, size, arma::fill::zeros);
+        for (std::size_t d = 0; d < junction_vec.size(); d++) {
+            vec a(size, arma::fill::zeros);
+            if (junction_vec[d].node_1_index >= 0)
+                a(junction_vec[d].node_1_index) += 1;
+            if (junction_vec[d].node_2_index >= 0)
+                a(junction_vec[d].node_2_index) -= 1;
+            D_avg += arma::mean(g_t.col(d)) * a * a.t();
+        }
+        vector<cx_mat> L_vec(N), U_vec(N), P_vec(N);
+        bool factorized = true;
+        for (int k = 0; k < N; k++)
+            factorized = factorized &&
+                         arma::lu(L_vec[k], U_vec[k], P_vec[k], cx_mat(Y_vec[k] + D_avg));
+        if (!factorized) {
+            cout << "Harmonic balance: singular preconditioner" << endl;
+            break;
+        }
+        LinearOperator preconditioner = [&](const cx_vec& v) {
+            cx_mat V_f = arma::reshape(v, N, size);
+            for (int k = 0; k < N; k++) {
+                cx_vec rhs = P_vec[k] * V_f.row(k).st();
+                cx_vec z = arma::solve(arma::trimatl(L_vec[k]), rhs);
+                V_f.row(k) = arma::solve(arma::trimatu(U_vec[k]), z).st();
+            }
+            return cx_vec(arma::vectorise(V_f));
+        };
+
+        int gmres_iter = 0;
+        cx_vec dx = Gmres(jacobian, preconditioner, cx_vec(-1 * arma::vectorise(R_f)),
+                          HB_GMRES_DIM, HB_GMRES_TOL, gmres_iter);
+        gmres_iter_sum += gmres_iter;
+        if (!dx.is_finite()) {
+            cout << "Harmonic balance: GMRES failed" << endl;
+            break;
+        }
+        cx_mat dX_f = arma::reshape(dx, N, size);
+        X_t = arma::real(to_time(X_f));
+        mat dX_t = arma::real(to_time(dX_f));
+
+        // Junction limiting in every sample
+        double lambda = 1;
+        for (int n = 0; n < M; n++)
+            lambda = std::min(lambda, JunctionStepLimit(junction_vec, X_t.row(n).t(),
+                                                        dX_t.row(n).t()));
+        cx_mat X_try = X_f + lambda * dX_f;
+        apply_diode_current(X_try, I_f, g_t);
+        R_f = apply_linear(X_try) + I_f - B_f;
+
+        // Both the full update and the residual after it are small enough.
+        converged = lambda == 1 && check_residual(X_try, I_f, R_f);
+        for (int n = 0; n < M && converged; n++)
+            converged = CheckUpdate(X_t.row(n).t(), vec((X_t + dX_t).row(n).t()),
+                                    voltage_num, newton_setting.criteria);
+        if (converged) {
+            X_f = X_try;
+            break;
+        }
+
+        // Armijo line search on the residual
+        double residual_try = arma::norm(R_f, "fro");
+        while (residual_try > (1 - ARMIJO_ALPHA * lambda) * residual_n &&
+               lambda > DAMPING_MIN) {
+            lambda /= 2;
+            X_try = X_f + lambda * dX_f;
+            apply_diode_current(X_try, I_f, g_t);
+            R_f = apply_linear(X_try) + I_f - B_f;
+            residual_try = arma::norm(R_f, "fro");
+        }
+        X_f = X_try;
+        residual_n = residual_try;
+    }
+    iter_num = std::min(iter_num, newton_setting.max_iter);
+
+    cout << "Harmonic balance at f0 = " << hb_analysis.f0 << " with " << harmonic_num
+         << " harmonics: " << (converged ? "converged" : "not converged") << " after "
+         << iter_num << " Newton iterations, " << gmres_iter_sum << " GMRES iterations"
+         << endl;
+
+    // One-sided amplitudes: |X_0| and 2 * |X_k|
+    mat amplitude_mat(harmonic_num + 1, size);
+    for (int k = 0; k <= harmonic_num; k++)
+        amplitude_mat.row(k) = (k == 0 ? 1.0 : 2.0) * arma::abs(X_f.row(k));
+    hb_result = HbResult{hb_analysis.f0, amplitude_mat, node_vec};
+
+    vector<int> output_index_vec;
+    for (PrintVariable print_variable : print_variable_vec) {
+        NodeName name = print_variable.print_i_v == I ? "i_" + print_variable.node
+                                                      : print_variable.node;
+        if (node_index.contains(name))
+            output_index_vec.push_back(node_index.value(name));
+    }
+    if (output_index_vec.empty())
+        for (int i = 0; i < voltage_num; i++)
+            output_index_vec.push_back(i);
+
+    cout << setw(10) << "node" << setw(14) << "dc";
+    for (int k = 1; k <= harmonic_num; k++)
+        cout << setw(13) << "h" << k;
+    cout << setw(14) << "thd(%)" << endl;
+    for (int index : output_index_vec) {
+        cout << setw(10) << node_vec[index];
+        for (int k = 0; k <= harmonic_num; k++)
+            cout << setw(14) << amplitude_mat(k, index);
+        double thd = 0;
+        if (harmonic_num >= 2 && amplitude_mat(1, index) > 0)
+            thd = 100 *
+                  arma::norm(amplitude_mat(arma::span(2, harmonic_num), index)) /
+                  amplitude_mat(1, index);
+        cout << setw(14) << thd << endl;
+    }
+}
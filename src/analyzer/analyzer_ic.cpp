@@ -0,0 +1,153 @@
+/**
+ * @file analyzer_ic.cpp
+ * @brief Initial conditions: .ic, .nodeset and the transient operating point
+ * @date 2026-10-19
+ */
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::span;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::vector;
+
+// A .ic node is held at its value through this conductance to gnd while the
+// operating point before a transient is solved, a .nodeset node while the
+// starting point of a DC solve is.
+constexpr double IC_CONDUCTANCE = 1e9;
+
+/**
+ * @brief The state a transient starts from. By default it is the DC operating
+ * point of the Backward Euler system with the sources at t_start, so the
+ * sources are stamped as in the steps that follow, the .ic nodes held by
+ * IC_CONDUCTANCE and released once the transient starts. With uic no
+ * operating point is solved: the .ic nodes start at their values and
+ * everything else at zero.
+ *
+ * @param tran_analysis
+ * @param node_vec the unknowns of the transient, gnd removed
+ * @return the state on node_vec, matched by name
+ */
+vec Analyzer::GetTranInitialState(const TranAnalysis tran_analysis,
+                                  const vector<NodeName>& node_vec) {
+    QHash<NodeName, int> node_index = GetNodeIndex(node_vec);
+    const int voltage_num = circuit.node_vec.size() - 1;
+    vec x_0(node_vec.size(), arma::fill::zeros);
+
+    for (const NodeVoltage& ic : ic_vec) {
+        int index = node_index.value(ic.node, -1);
+        if (index < 0 || index >= voltage_num)
+            cout << "Unknown node in .ic: " << ic.node << endl;
+        else if (tran_analysis.uic)
+            x_0(index) = ic.value;
+    }
+    if (tran_analysis.uic)
+        return x_0;
+
+    // The transient system with an infinite step: capacitors open, inductors
+    // short, and the sources as the transient sees them at t_start.
+    TranAnalysisMat tran_analysis_mat = BackEuler(circuit, arma::datum::inf);
+    int node_num = tran_analysis_mat.node_vec.size();
+    span reduced(1, node_num - 1);
+    mat reduced_mat = tran_analysis_mat.MNA(reduced, reduced);
+
+    std::vector<NodeName> op_node_vec = tran_analysis_mat.node_vec;
+    op_node_vec.erase(op_node_vec.begin());
+
+    SourceTable source_table;
+    source_table.Build(circuit, op_node_vec);
+    vec rhs(node_num - 1, arma::fill::zeros);
+    source_table.Apply(tran_analysis.t_start, rhs);
+
+    // Node voltages come first in both systems, in the same order.
+    for (const NodeVoltage& ic : ic_vec) {
+        int index = node_index.value(ic.node, -1);
+        if (index < 0 || index >= voltage_num)
+            continue;
+        reduced_mat(index, index) += IC_CONDUCTANCE;
+        rhs(index) += IC_CONDUCTANCE * ic.value;
+    }
+
+    vec result(node_num - 1, arma::fill::zeros);
+    LuFactor lu;
+    bool converged;
+    if (circuit.diode_vec.empty()) {
+        converged = lu.Factorize(reduced_mat);
+        run_stat.factorization_num++;
+        if (converged) {
+            result = lu.Solve(rhs);
+            run_stat.solve_num++;
+        }
+    } else {
+        NewtonSystem system(reduced_mat, tran_analysis_mat.exp_analysis_vec, rhs,
+                            tran_analysis_mat.exp_rhs_vec, voltage_num);
+        NewtonSetting newton_setting(options);
+        newton_setting.lu = &lu;
+        newton_setting.stat = &run_stat;
+        ConvergenceReport report;
+        LoadOperatingPoint(op_node_vec, result);
+        SeedNodeset(system, result);
+        converged = SolveOperatingPoint(system, newton_setting, result, report);
+        if (!converged || report.strategy_vec.size() > 1 || report.pseudo_tran_ran) {
+            cout << "Transient operating point:" << endl;
+            PrintConvergenceReport(report);
+        }
+        // The sources at t_start and the held .ic nodes make it a different point
+        // from the DC one in the cache, so it is only read as a warm start.
+    }
+    if (!converged) {
+        cout << "Operating point failed, the transient starts from zero" << endl;
+        return x_0;
+    }
+
+    // Capacitor currents are zero at DC.
+    for (int i = 0; i < node_num - 1; i++) {
+        int index = node_index.value(op_node_vec[i], -1);
+        if (index >= 0)
+            x_0(index) = result(i);
+    }
+    return x_0;
+}
+
+/**
+ * @brief Starting point of a nonlinear DC solve from the .nodeset hints. The
+ * system is first solved with the hinted nodes held at their values by
+ * IC_CONDUCTANCE. The caller then solves the free system from there, so the
+ * hints pick the starting point, and with it the state of a multi-stable
+ * circuit, but not the answer.
+ *
+ * @param system the DC system, changed only in this copy
+ * @param result the starting point, replaced by the held solution
+ */
+void Analyzer::SeedNodeset(NewtonSystem system, vec& result) {
+    if (nodeset_vec.empty() || system.exp_analysis_vec.empty())
+        return;
+
+    // gnd is node 0 and is removed from the system.
+    QHash<NodeName, int> node_index = GetNodeIndex(circuit.node_vec);
+    vec x = result;
+    for (const NodeVoltage& nodeset : nodeset_vec) {
+        int index = node_index.value(nodeset.node, 0) - 1;
+        if (index < 0) {
+            cout << "Unknown node in .nodeset: " << nodeset.node << endl;
+            continue;
+        }
+        system.mat(index, index) += IC_CONDUCTANCE;
+        system.rhs(index) += IC_CONDUCTANCE * nodeset.value;
+        x(index) = nodeset.value;
+    }
+    system.MatChanged();
+    result = x;
+
+    LuFactor lu;
+    NewtonSetting newton_setting(options);
+    newton_setting.lu = &lu;
+    newton_setting.stat = &run_stat;
+    int iter_num = 0;
+    if (NewtonSolve(system, newton_setting, x, iter_num))
+        result = x;
+    else
+        cout << "Nodeset: held solve failed, starting from the hints" << endl;
+}
@@ -0,0 +1,254 @@
+/**
+ * @file analyzer_incremental.cpp
+ * @brief Incremental DC solve for element value changes via low-rank updates
+ * @date 2026-10-19
+ */
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::span;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::setw;
+
+// LowRankSolver refactorizes once the accumulated update exceeds this rank,
+// and rejects an update whose capacitance matrix K has a smaller rcond.
+constexpr int LOW_RANK_MAX = 16;
+constexpr double LOW_RANK_RCOND_MIN = 1e-12;
+
+bool LowRankSolver::Factorize(const mat& A) {
+    base = A;
+    U.reset();
+    V.reset();
+    Z.reset();
+    K.reset();
+    return lu.Factorize(A);
+}
+
+/**
+ * @brief A += u * v^T. Once the accumulated rank exceeds LOW_RANK_MAX the
+ * updates are folded into A and it is refactorized.
+ *
+ * @return false: the updated matrix is singular, the update is not applied
+ */
+bool LowRankSolver::Update(const vec& u, const vec& v) {
+    if (Rank() >= LOW_RANK_MAX) {
+        LowRankSolver folded;
+        if (!folded.Factorize(base + U * V.t() + u * v.t()))
+            return false;
+        folded.refactor_num = refactor_num + 1;
+        *this = folded;
+        return true;
+    }
+
+    // A + U V^T is singular exactly when K is.
+    mat V_new = arma::join_rows(V, v);
+    mat Z_new = arma::join_rows(Z, lu.Solve(u));
+    mat K_new = arma::eye(V_new.n_cols, V_new.n_cols) + V_new.t() * Z_new;
+    if (!(arma::rcond(K_new) >= LOW_RANK_RCOND_MIN))
+        return false;
+
+    U = arma::join_rows(U, u);
+    V = V_new;
+    Z = Z_new;
+    K = K_new;
+    return true;
+}
+
+/**
+ * @brief (A + U V^T)^{-1} b = x0 - Z * K^{-1} * V^T * x0, with x0 = A^{-1} b
+ */
+vec LowRankSolver::Solve(const vec& b) const {
+    vec x0 = lu.Solve(b);
+    if (Rank() == 0)
+        return x0;
+    return x0 - Z * arma::solve(K, V.t() * x0);
+}
+
+/**
+ * @brief Factorize the DC matrix the element changes are applied to.
+ *
+ * @return false: the DC matrix is singular
+ */
+bool Analyzer::InitIncremental() {
+    AnalysisMatrix analysis_matrix = GetAnalysisMatrix(0);
+    int node_num = analysis_matrix.node_vec.size();
+
+    // `reduced` means remove the 0(gnd) node.
+    mat reduced_mat = GetReal(analysis_matrix.linear_analysis_mat(span(1, node_num - 1),
+                                                                  span(1, node_num - 1)));
+    incremental_rhs = GetReal(analysis_matrix.rhs(span(1, node_num - 1), 0));
+
+    incremental_node_vec = analysis_matrix.node_vec;
+    incremental_node_vec.erase(incremental_node_vec.begin());
+
+    run_stat.factorization_num++;
+    incremental_ready = low_rank_solver.Factorize(reduced_mat);
+    if (!incremental_ready)
+        cout << "Singular MNA matrix, no incremental solve" << endl;
+    return incremental_ready;
+}
+
+// Index in the reduced system, -1 for gnd
+int Analyzer::ReducedIndex(const NodeName node) {
+    return FindNode(incremental_node_vec, node);
+}
+
+// e_1 - e_2 in the reduced system, gnd entries dropped
+vec Analyzer::UnitVec(const int index_1, const int index_2) {
+    vec u(incremental_node_vec.size(), arma::fill::zeros);
+    if (index_1 >= 0)
+        u(index_1) += 1;
+    if (index_2 >= 0)
+        u(index_2) -= 1;
+    return u;
+}
+
+/**
+ * @brief Change the value of one element. The DC matrix is updated as a
+ * rank-1 correction of the existing factorization instead of being rebuilt.
+ *
+ * @param name
+ * @param value positive for R, L and C, finite otherwise
+ * @return true: the element exists, the circuit is linear and the changed DC
+ * matrix is nonsingular; otherwise nothing is changed
+ */
+bool Analyzer::ChangeElementValue(const DeviceName name, const double value) {
+    if (!circuit.diode_vec.empty()) {
+        cout << "Incremental solve only supports linear circuits" << endl;
+        return false;
+    }
+    if (!std::isfinite(value)) {
+        cout << "Invalid value for " << name << endl;
+        return false;
+    }
+    if (!incremental_ready && !InitIncremental())
+        return false;
+    auto singular = [&name]() {
+        cout << "Changing " << name << " makes the DC matrix singular, not applied"
+             << endl;
+        return false;
+    };
+
+    for (Res& res : circuit.res_vec) {
+        if (res.name != name)
+            continue;
+        if (value <= 0) {
+            cout << "Resistance of " << name << " must be positive" << endl;
+            return false;
+        }
+        // g * (e1 - e2) * (e1 - e2)^T
+        vec u = UnitVec(ReducedIndex(res.node_1), ReducedIndex(res.node_2));
+        if (!low_rank_solver.Update(u, (1 / value - 1 / res.value) * u))
+            return singular();
+        res.value = value;
+        operating_point_ready = false;
+        return true;
+    }
+
+    // Capacitors are open and inductors are shorted at DC.
+    for (Cap& cap : circuit.cap_vec) {
+        if (cap.name != name)
+            continue;
+        if (value <= 0) {
+            cout << "Capacitance of " << name << " must be positive" << endl;
+            return false;
+        }
+        cap.value = value;
+        operating_point_ready = false;
+        return true;
+    }
+    for (Ind& ind : circuit.ind_vec) {
+        if (ind.name != name)
+            continue;
+        if (value <= 0) {
+            cout << "Inductance of " << name << " must be positive" << endl;
+            return false;
+        }
+        ind.value = value;
+        operating_point_ready = false;
+        return true;
+    }
+
+    for (VCCS& vccs : circuit.vccs_vec) {
+        if (vccs.name != name)
+            continue;
+        // g * (e1 - e2) * (e_ctrl1 - e_ctrl2)^T
+        vec u = UnitVec(ReducedIndex(vccs.node_1), ReducedIndex(vccs.node_2));
+        vec v = UnitVec(ReducedIndex(vccs.ctrl_node_1), ReducedIndex(vccs.ctrl_node_2));
+        if (!low_rank_solver.Update(u, (value - vccs.value) * v))
+            return singular();
+        vccs.value = value;
+        operating_point_ready = false;
+        return true;
+    }
+
+    for (VCVS& vcvs : circuit.vcvs_vec) {
+        if (vcvs.name != name)
+            continue;
+        // -mu * e_branch * (e_ctrl1 - e_ctrl2)^T
+        vec u = UnitVec(ReducedIndex("i_" + vcvs.name), -1);
+        vec v = UnitVec(ReducedIndex(vcvs.ctrl_node_1), ReducedIndex(vcvs.ctrl_node_2));
+        if (!low_rank_solver.Update(u, -1 * (value - vcvs.value) * v))
+            return singular();
+        vcvs.value = value;
+        operating_point_ready = false;
+        return true;
+    }
+
+    // Sources only change the RHS.
+    for (Vsrc& vsrc : circuit.vsrc_vec) {
+        if (vsrc.name != name)
+            continue;
+        incremental_rhs(ReducedIndex("i_" + vsrc.name)) = value;
+        vsrc.value = value;
+        operating_point_ready = false;
+        return true;
+    }
+    for (Isrc& isrc : circuit.isrc_vec) {
+        if (isrc.name != name)
+            continue;
+        incremental_rhs += (value - isrc.value) *
+                           UnitVec(ReducedIndex(isrc.node_1), ReducedIndex(isrc.node_2));
+        isrc.value = value;
+        operating_point_ready = false;
+        return true;
+    }
+
+    cout << "Not found: " << name << endl;
+    return false;
+}
+
+/**
+ * @brief The DC operating point with all element changes applied so far.
+ *
+ * @return arma::vec in the order of GetIncrementalNodes()
+ */
+vec Analyzer::SolveIncremental() {
+    if (!incremental_ready && !InitIncremental())
+        return vec();
+    run_stat.solve_num++;
+    return low_rank_solver.Solve(incremental_rhs);
+}
+
+/**
+ * @brief Apply the .alter changes one after another, printing the DC
+ * operating point after each. All of them are low-rank updates of a single
+ * factorization of the original DC matrix.
+ *
+ * @param alter_vec
+ */
+void Analyzer::DoAlterAnalysis(const std::vector<ElementChange>& alter_vec) {
+    for (const ElementChange& change : alter_vec) {
+        cout << "Alter " << change.name << " = " << change.value << endl;
+        if (!ChangeElementValue(change.name, change.value))
+            continue;
+        vec x = SolveIncremental();
+        for (std::size_t i = 0; i < x.n_elem; i++)
+            cout << setw(10) << incremental_node_vec[i] << setw(14) << x(i) << endl;
+    }
+    cout << low_rank_solver.refactor_num << " refactorizations for "
+         << alter_vec.size() << " changes" << endl;
+}
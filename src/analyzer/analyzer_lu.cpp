@@ -0,0 +1,215 @@
+/**
+ * @file analyzer_lu.cpp
+ * @brief Reusable LU factorization with partial refactorization
+ * @date 2026-10-19
+ */
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::span;
+using arma::uvec;
+using arma::uword;
+using arma::vec;
+
+// Threshold partial pivoting: any pivot within this fraction of the largest
+// entry of the column may be chosen.
+constexpr double PIVOT_THRESHOLD = 0.1;
+
+/**
+ * @brief Right-looking Gaussian elimination of W. With `late_row` given,
+ * pivots are picked by threshold partial pivoting, preferring rows that are
+ * not late, and row_perm follows the row swaps. Without it the row order is
+ * kept.
+ *
+ * @return true: every pivot is nonzero
+ */
+static bool Eliminate(mat& W, uvec& row_perm, const std::vector<bool>* late_row) {
+    const uword n = W.n_rows;
+
+    for (uword k = 0; k < n; k++) {
+        if (late_row) {
+            double max_abs = arma::abs(W(span(k, n - 1), k)).max();
+            uword p = k;
+            bool p_late = true;
+            double p_abs = -1;
+            for (uword i = k; i < n; i++) {
+                double a = fabs(W(i, k));
+                if (a < PIVOT_THRESHOLD * max_abs)
+                    continue;
+                bool i_late = (*late_row)[row_perm(i)];
+                if ((p_late && !i_late) || (p_late == i_late && a > p_abs)) {
+                    p = i;
+                    p_late = i_late;
+                    p_abs = a;
+                }
+            }
+            if (p != k) {
+                W.swap_rows(k, p);
+                std::swap(row_perm(k), row_perm(p));
+            }
+        }
+
+        double pivot = W(k, k);
+        if (pivot == 0 || !std::isfinite(pivot))
+            return false;
+
+        if (k + 1 < n) {
+            span rest(k + 1, n - 1);
+            W(rest, k) /= pivot;
+            W(rest, rest) -= W(rest, k) * W(k, rest);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Split the eliminated trailing block W into unit lower L and upper U
+ * from step `first_step` on.
+ */
+static void StoreFactors(const mat& W, mat& L, mat& U, const uword first_step) {
+    span trail(first_step, L.n_rows - 1);
+
+    mat L_trail = arma::trimatl(W);
+    L_trail.diag().ones();
+    L(trail, trail) = L_trail;
+    U(trail, trail) = arma::trimatu(W);
+}
+
+/**
+ * @brief Factorize A with LAPACK partial pivoting, P * A = L * U.
+ *
+ * @param A
+ * @return true: A is nonsingular
+ */
+bool LuFactor::Factorize(const mat& A) {
+    const uword n = A.n_rows;
+    mat P;
+    linear_version = -1;
+    valid = arma::lu(L, U, P, A);
+    if (valid) {
+        vec pivot = U.diag();
+        valid = pivot.is_finite() && arma::all(pivot != 0);
+    }
+    if (!valid)
+        return false;
+
+    row_perm = arma::conv_to<uvec>::from(P * arma::regspace<vec>(0, n - 1));
+    col_perm = arma::regspace<uvec>(0, n - 1);
+    row_pos.set_size(n);
+    row_pos.elem(row_perm) = arma::regspace<uvec>(0, n - 1);
+    col_pos = col_perm;
+    return true;
+}
+
+/**
+ * @brief Factorize A(row_perm, col_perm) = L * U. The rows and columns marked
+ * in `late` (e.g. the ones stamped by nonlinear devices) are moved as far back
+ * as the pivoting allows, so that a later Refactor only has to recompute a
+ * short trailing part.
+ *
+ * @param A
+ * @param late empty or one flag per row/column
+ * @return true: A is nonsingular
+ */
+bool LuFactor::Factorize(const mat& A, const std::vector<bool>& late) {
+    const uword n = A.n_rows;
+    std::vector<bool> late_row = late;
+    late_row.resize(n, false);
+
+    std::vector<uword> col_vec;
+    for (uword j = 0; j < n; j++)
+        if (!late_row[j])
+            col_vec.push_back(j);
+    for (uword j = 0; j < n; j++)
+        if (late_row[j])
+            col_vec.push_back(j);
+    col_perm = uvec(col_vec);
+    row_perm = arma::regspace<uvec>(0, n - 1);
+
+    mat W = A.cols(col_perm);
+    L.zeros(n, n);
+    U.zeros(n, n);
+    linear_version = -1;
+
+    valid = Eliminate(W, row_perm, &late_row);
+    if (!valid)
+        return false;
+
+    StoreFactors(W, L, U, 0);
+    row_pos.set_size(n);
+    row_pos.elem(row_perm) = arma::regspace<uvec>(0, n - 1);
+    col_pos.set_size(n);
+    col_pos.elem(col_perm) = arma::regspace<uvec>(0, n - 1);
+    return true;
+}
+
+/**
+ * @brief Refactorize A keeping the pivot sequence of the last Factorize. Only
+ * the elimination steps from `first_step` on are redone, which is exact as
+ * long as A differs from the factorized matrix only in entries whose row and
+ * column both sit at or after `first_step`.
+ *
+ * @param A
+ * @param first_step from FirstStep()
+ * @return true: no pivot became zero; otherwise a full Factorize is needed
+ */
+bool LuFactor::Refactor(const mat& A, const int first_step) {
+    const uword n = A.n_rows;
+    const uword k0 = first_step;
+    if (k0 >= n)
+        return valid;
+
+    // Only the trailing block changes, L(trail, head) and the head rows stay.
+    mat W = A.submat(row_perm.tail(n - k0), col_perm.tail(n - k0));
+    span trail(k0, n - 1);
+    if (k0 > 0) {
+        span head(0, k0 - 1);
+        W -= L(trail, head) * U(head, trail);
+    }
+
+    uvec unused;
+    valid = Eliminate(W, unused, nullptr);
+    if (valid)
+        StoreFactors(W, L, U, k0);
+    return valid;
+}
+
+/**
+ * @brief The first elimination step affected by a change of the entries the
+ * ExpTerms stamp into the matrix.
+ */
+int LuFactor::FirstStep(const std::vector<ExpTerm>& exp_term_vec) const {
+    int first_step = L.n_rows;
+    for (const ExpTerm& term : exp_term_vec) {
+        if (term.row_index < 0 || term.col_index < 0)
+            continue;
+        int step = std::min(row_pos(term.row_index), col_pos(term.col_index));
+        first_step = std::min(first_step, step);
+    }
+    return first_step;
+}
+
+/**
+ * @brief Solve A * x = b with two triangular substitutions. b may have
+ * several columns.
+ */
+mat LuFactor::Solve(const mat& b) const {
+    mat y = arma::solve(arma::trimatl(L), mat(b.rows(row_perm)));
+    mat z = arma::solve(arma::trimatu(U), y);
+    mat x(z.n_rows, z.n_cols);
+    x.rows(col_perm) = z;
+    return x;
+}
+
+/**
+ * @brief Solve A^T * x = b with the same factors, as needed by adjoint
+ * analyses: U^T * L^T * x(row_perm) = b(col_perm).
+ */
+mat LuFactor::SolveTransposed(const mat& b) const {
+    mat z = arma::solve(arma::trimatl(U.t()), mat(b.rows(col_perm)));
+    mat w = arma::solve(arma::trimatu(L.t()), z);
+    mat x(w.n_rows, w.n_cols);
+    x.rows(row_perm) = w;
+    return x;
+}
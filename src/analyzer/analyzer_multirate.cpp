@@ -0,0 +1,251 @@
+/**
+ * @file analyzer_multirate.cpp
+ * @brief Multirate transient with latent blocks frozen
+ * @date 2026-10-19
+ */
+
+#include <algorithm>
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::span;
+using arma::uvec;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::setw;
+using std::vector;
+
+// An undriven block doubles its step up to MULTIRATE_MAX_RATIO while it
+// changes by less than MULTIRATE_SLOW times the Newton tolerance per step,
+// and a block is latent while its RHS moves by less than
+// MULTIRATE_LATENCY_TOL relative.
+constexpr int MULTIRATE_MAX_RATIO = 16;
+constexpr double MULTIRATE_SLOW = 10;
+constexpr double MULTIRATE_LATENCY_TOL = 1e-9;
+
+/**
+ * @brief Backward Euler transient on loosely coupled blocks. Each block steps
+ * `ratio` global steps at a time, slowest first, seeing the other blocks
+ * through their interpolated (or, for blocks behind it, held) values. A block
+ * whose matrix and RHS are the same as in its last step has the same
+ * solution and is frozen without a solve. Blocks without Pulse or Sin
+ * sources double their step while they change slowly, and halve it when the
+ * interface values they held turn out to be too far off.
+ *
+ * @param tran_analysis
+ */
+void Analyzer::DoMultirateTranAnalysis(const TranAnalysis tran_analysis) {
+    const double t_start = tran_analysis.t_start;
+    const double h = tran_analysis.t_step;
+    const int scan_num = (tran_analysis.t_stop - t_start) / h;
+
+    // MNA(h) = A0 + A1 / h and RHS_gen(h) = R1 / h, split from two step sizes
+    TranAnalysisMat be_1 = BackEuler(circuit, h);
+    TranAnalysisMat be_2 = BackEuler(circuit, 2 * h);
+    const int total_node_num = be_1.node_vec.size();
+    span reduced(1, total_node_num - 1);
+    mat M_1 = be_1.MNA(reduced, reduced);
+    mat A1 = 2 * h * (M_1 - be_2.MNA(reduced, reduced));
+    mat A0 = M_1 - A1 / h;
+    mat R1 = h * be_1.RHS_gen(reduced, reduced);
+
+    vector<NodeName> node_vec = be_1.node_vec;
+    node_vec.erase(node_vec.begin());
+    const int size = node_vec.size();
+    const arma::uword voltage_num = circuit.node_vec.size() - 1;
+
+    SourceTable source_table;
+    source_table.Build(circuit, node_vec);
+    uvec driven_index = arma::join_cols(source_table.pulse_index, source_table.sin_index);
+
+    const vec x_0 = GetTranInitialState(tran_analysis, node_vec);
+
+    vector<uvec> block_vec =
+        PartitionUnknowns(M_1, be_1.exp_analysis_vec, MULTIRATE_COUPLING);
+    vector<TranPartition> part_vec(block_vec.size());
+    for (std::size_t k = 0; k < block_vec.size(); k++) {
+        TranPartition& part = part_vec[k];
+        part.index = block_vec[k];
+        vector<bool> inside(size, false);
+        for (arma::uword i : part.index)
+            inside[i] = true;
+        vector<arma::uword> other_vec;
+        for (int i = 0; i < size; i++)
+            if (!inside[i])
+                other_vec.push_back(i);
+        part.other = uvec(other_vec);
+
+        part.x_start = x_0(part.index);
+        part.x_end = part.x_start;
+        vector<ExpTerm> exp_analysis_vec =
+            RestrictExpTerms(be_1.exp_analysis_vec, part.index, false);
+        vector<ExpTerm> exp_rhs_vec =
+            RestrictExpTerms(be_1.exp_rhs_vec, part.index, true);
+        part.system = NewtonSystem(mat(), exp_analysis_vec, mat(), exp_rhs_vec,
+                                   arma::accu(part.index < voltage_num));
+        part.nonlinear = !part.system.exp_analysis_vec.empty();
+        for (arma::uword i : driven_index)
+            part.driven = part.driven || inside[i];
+    }
+
+    // A block at grid index n: interpolated inside its step, held after it
+    auto value_at = [](const TranPartition& part, int n) {
+        if (n >= part.n_end || part.n_end == part.n_start)
+            return part.x_end;
+        if (n <= part.n_start)
+            return part.x_start;
+        double s = static_cast<double>(n - part.n_start) / (part.n_end - part.n_start);
+        return vec((1 - s) * part.x_start + s * part.x_end);
+    };
+    auto global_at = [&](int n) {
+        vec x(size);
+        for (const TranPartition& part : part_vec)
+            x(part.index) = value_at(part, n);
+        return x;
+    };
+
+    // One Backward Euler step of `steps` global steps for block k, x_new holds
+    // the guess. false: the block matrix is singular.
+    auto solve_block = [&](int k, int steps, const mat& M_rows, const vec& rhs, double t,
+                           vec& x_new) {
+        TranPartition& part = part_vec[k];
+        LuFactor& lu = part.lu_map[steps];
+        if (!part.nonlinear) {
+            if (!lu.valid) {
+                run_stat.factorization_num++;
+                if (!lu.Factorize(mat(M_rows.cols(part.index)))) {
+                    cout << "Singular MNA matrix in partition " << k
+                         << ", transient stopped at t = " << t << endl;
+                    return false;
+                }
+            }
+            x_new = lu.Solve(rhs);
+            run_stat.solve_num++;
+            return true;
+        }
+        if (part.system_steps != steps) {
+            part.system.mat = M_rows.cols(part.index);
+            part.system.MatChanged();
+            part.system_steps = steps;
+        }
+        part.system.rhs = rhs;
+        NewtonSetting newton_setting(options);
+        newton_setting.stat = &run_stat;
+        newton_setting.lu = &lu;
+        int iter_num = 0;
+        if (!NewtonSolve(part.system, newton_setting, x_new, iter_num))
+            cout << "Newton failed to converge at t = " << t << " in partition " << k
+                 << endl;
+        return true;
+    };
+
+    const ConvergenceCriteria criteria(options);
+    mat tran_result_mat(size, scan_num + 1, arma::fill::zeros);
+    tran_result_mat.col(0) = x_0;
+    std::vector<double> time_point_vec = {t_start};
+    vector<int> order(part_vec.size());
+    for (int n = 1; n <= scan_num; n++) {
+        time_point_vec.push_back(t_start + n * h);
+
+        for (std::size_t k = 0; k < order.size(); k++)
+            order[k] = k;
+        std::stable_sort(order.begin(), order.end(), [&part_vec](int a, int b) {
+            return part_vec[a].ratio > part_vec[b].ratio;
+        });
+
+        for (int k : order) {
+            TranPartition& part = part_vec[k];
+            if (part.n_end >= n)
+                continue;
+            const int n_new = std::min(part.n_end + part.ratio, scan_num);
+            const int steps = n_new - part.n_end;
+            const double h_part = steps * h;
+
+            vec x_prev = global_at(part.n_end);
+            vec x_guess = global_at(n_new);
+            vec b(size, arma::fill::zeros);
+            source_table.Apply(t_start + n_new * h, b);
+
+            mat M_rows = A0.rows(part.index) + A1.rows(part.index) / h_part;
+            vec rhs = R1.rows(part.index) * x_prev / h_part + vec(b(part.index));
+            if (!part.other.is_empty())
+                rhs -= M_rows.cols(part.other) * x_guess(part.other);
+
+            // Same matrix and RHS as the last step: same solution.
+            bool latent = steps == part.last_ratio &&
+                          arma::norm(rhs - part.last_rhs, "inf") <=
+                              MULTIRATE_LATENCY_TOL * (1 + arma::norm(rhs, "inf"));
+            vec x_new = part.x_end;
+            if (latent)
+                part.latent_num++;
+            else {
+                if (!solve_block(k, steps, M_rows, rhs, t_start + n_new * h, x_new))
+                    return;
+                part.step_num++;
+
+                if (!part.driven) {
+                    double change = arma::norm(x_new - part.x_end, "inf");
+                    double tol =
+                        criteria.vntol + criteria.reltol * arma::norm(x_new, "inf");
+                    if (change < MULTIRATE_SLOW * tol && n_new % (2 * part.ratio) == 0 &&
+                        2 * part.ratio <= MULTIRATE_MAX_RATIO)
+                        part.ratio *= 2;
+                    else if (change > MULTIRATE_SLOW * tol * part.ratio)
+                        part.ratio = 1;
+                    part.max_ratio = std::max(part.max_ratio, part.ratio);
+                }
+            }
+            part.last_rhs = rhs;
+            part.last_ratio = steps;
+            part.other_guess = x_guess(part.other);
+            part.x_start = part.x_end;
+            part.n_start = part.n_end;
+            part.x_end = x_new;
+            part.n_end = n_new;
+        }
+
+        // The faster blocks have now caught up with the blocks whose long step
+        // ends at n, which assumed held values for them. Such a step is solved
+        // again with the real interface values, and rejected, with its ratio
+        // halved, if that moves it by more than the Newton tolerance.
+        for (std::size_t k = 0; k < part_vec.size(); k++) {
+            TranPartition& part = part_vec[k];
+            const int steps = part.n_end - part.n_start;
+            if (part.n_end != n || steps < 2 || part.other.is_empty())
+                continue;
+            mat M_rows = A0.rows(part.index) + A1.rows(part.index) / (steps * h);
+            vec x_other = global_at(n)(part.other);
+            vec rhs =
+                part.last_rhs - M_rows.cols(part.other) * (x_other - part.other_guess);
+            if (arma::norm(rhs - part.last_rhs, "inf") <=
+                MULTIRATE_LATENCY_TOL * (1 + arma::norm(rhs, "inf")))
+                continue;
+
+            vec x_new = part.x_end;
+            if (!solve_block(k, steps, M_rows, rhs, t_start + n * h, x_new))
+                return;
+            double tol = criteria.vntol + criteria.reltol * arma::norm(x_new, "inf");
+            if (arma::norm(x_new - part.x_end, "inf") > tol) {
+                part.reject_num++;
+                part.ratio = std::max(1, part.ratio / 2);
+            }
+            part.x_end = x_new;
+            part.last_rhs = rhs;
+            part.other_guess = x_other;
+        }
+        tran_result_mat.col(n) = global_at(n);
+    }
+    tran_result = TranResult{tran_result_mat, time_point_vec, node_vec};
+
+    cout << "Multirate transient: " << part_vec.size() << " partitions, " << scan_num
+         << " global steps" << endl;
+    cout << setw(10) << "partition" << setw(10) << "unknowns" << setw(10) << "steps"
+         << setw(10) << "latent" << setw(10) << "rejected" << setw(10) << "max ratio"
+         << endl;
+    for (std::size_t k = 0; k < part_vec.size(); k++)
+        cout << setw(10) << k << setw(10) << part_vec[k].index.n_elem << setw(10)
+             << part_vec[k].step_num << setw(10) << part_vec[k].latent_num << setw(10)
+             << part_vec[k].reject_num << setw(10) << part_vec[k].max_ratio << endl;
+}
@@ -0,0 +1,488 @@
+/**
+ * @file analyzer_newton.cpp
+ * @brief Newton iteration and the convergence aids for nonlinear operating points
+ * @date 2026-10-19
+ */
+
+#include <atomic>
+#include <chrono>
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::vec;
+using std::cout;
+using std::endl;
+
+// Chord Newton refactors once |dx| shrinks slower than this per iteration.
+constexpr double CHORD_RATE_MAX = 0.5;
+
+constexpr double GMIN_START = 1e-2;
+constexpr double GMIN_STOP = 1e-12;
+constexpr double GMIN_FACTOR = 10;
+constexpr double SOURCE_STEP_MIN = 1e-4;
+
+constexpr double PTRAN_CAP = 1;
+constexpr double PTRAN_H_START = 1e-3;
+constexpr double PTRAN_H_MAX = 1e9;
+constexpr double PTRAN_HANDOFF = 1e-3;
+constexpr int PTRAN_MAX_STEP = 1000;
+constexpr int PTRAN_NEWTON_ITER = 20;
+
+/**
+ * @brief A version number no NewtonSystem has had before.
+ */
+long NextMatVersion() {
+    static std::atomic<long> version(0);
+    return version++;
+}
+
+/**
+ * @brief Collect the diode junctions from the RHS ExpTerms. Each diode
+ * contributes a term a*e^{bx}+c with a = -i_sat, b = 1/vt on its node_1 row,
+ * tagged with its index in circuit.diode_vec.
+ */
+std::vector<Junction> GetJunctions(const std::vector<ExpTerm>& exp_rhs_vec) {
+    std::vector<Junction> junction_vec;
+    for (const ExpTerm& term : exp_rhs_vec) {
+        if (term.zero_order.exp.real() >= 0)
+            continue;
+        junction_vec.push_back(Junction(term.node_1_index, term.node_2_index,
+                                        1 / term.zero_order.exp.imag(),
+                                        -1 * term.zero_order.exp.real(),
+                                        term.device_index));
+    }
+    return junction_vec;
+}
+
+double JunctionVoltage(const Junction& junction, const vec& x) {
+    double v = 0;
+    if (junction.node_1_index >= 0)
+        v += x(junction.node_1_index);
+    if (junction.node_2_index >= 0)
+        v -= x(junction.node_2_index);
+    return v;
+}
+
+/**
+ * @brief SPICE pnjlim: limit the new junction voltage to a logarithmic step
+ * once it is above the critical voltage.
+ */
+double PnjLimit(const Junction& junction, double v_new, const double v_old) {
+    const double vt = junction.vt;
+    if (v_new > junction.v_crit && fabs(v_new - v_old) > 2 * vt) {
+        if (v_old > 0) {
+            double arg = 1 + (v_new - v_old) / vt;
+            if (arg > 0)
+                v_new = v_old + vt * log(arg);
+            else
+                v_new = junction.v_crit;
+        } else if (v_new > vt) {
+            v_new = vt * log(v_new / vt);
+        }
+    }
+    return v_new;
+}
+
+/**
+ * @brief The largest fraction of the Newton step dx for which no junction
+ * moves further than pnjlim allows.
+ */
+double JunctionStepLimit(const std::vector<Junction>& junction_vec, const vec& x,
+                         const vec& dx) {
+    double lambda = 1;
+    for (const Junction& junction : junction_vec) {
+        double v_old = JunctionVoltage(junction, x);
+        double dv = JunctionVoltage(junction, x + dx) - v_old;
+        if (dv == 0)
+            continue;
+        double dv_limited = PnjLimit(junction, v_old + dv, v_old) - v_old;
+        lambda = std::min(lambda, dv_limited / dv);
+    }
+    return std::max(lambda, DAMPING_MIN);
+}
+
+/**
+ * @brief Factorize the Jacobian of `system` at x into `lu`. Rows and columns
+ * stamped by ExpTerms are factorized last, and when `lu` already holds a
+ * factorization of the same linear part only those are redone with the old
+ * pivot sequence.
+ *
+ * @param system
+ * @param x
+ * @param lu
+ * @param stat counters are added to if not null
+ * @return the fraction of the factorization recomputed, 0 if singular
+ */
+double FactorizeJacobian(const NewtonSystem& system, const vec& x, LuFactor& lu,
+                         RunStatistics* stat) {
+    const int size = system.mat.n_rows;
+    mat jacobian = AddExpTerm(system.exp_analysis_vec, x, system.mat);
+
+    if (lu.valid && lu.linear_version == system.mat_version) {
+        int first_step = lu.FirstStep(system.exp_analysis_vec);
+        if (lu.Refactor(jacobian, first_step)) {
+            double refactor_fraction = static_cast<double>(size - first_step) / size;
+            if (stat) {
+                stat->partial_refactor_num++;
+                stat->recomputed_fraction_sum += refactor_fraction;
+            }
+            return refactor_fraction;
+        }
+    }
+
+    std::vector<bool> nonlinear_flag(size, false);
+    for (const ExpTerm& term : system.exp_analysis_vec) {
+        if (term.row_index >= 0 && term.col_index >= 0) {
+            nonlinear_flag[term.row_index] = true;
+            nonlinear_flag[term.col_index] = true;
+        }
+    }
+
+    if (stat)
+        stat->factorization_num++;
+    if (!lu.Factorize(jacobian, nonlinear_flag))
+        return 0;
+    lu.linear_version = system.mat_version;
+    return 1;
+}
+
+/**
+ * @brief Damped Newton iteration with an iteration cap.
+ *
+ * With setting.chord the LU factorization of the Jacobian is reused, also
+ * across calls through setting.lu, and only redone once the update stops
+ * contracting by CHORD_RATE_MAX per iteration or the step had to be damped.
+ * A factorization of another linear part, left by gmin stepping,
+ * pseudo-transient or a held .nodeset solve, is never reused.
+ *
+ * The Newton step is first shortened so that no diode junction moves further
+ * than pnjlim allows, then halved until the residual decreases (Armijo line
+ * search).
+ *
+ * @param system
+ * @param setting
+ * @param result initial guess in, solution out
+ * @param iter_num number of iterations taken
+ * @return true: converged \
+ * @return false: hit the iteration cap or the matrix is singular
+ */
+bool NewtonSolve(const NewtonSystem& system, const NewtonSetting& setting, vec& result,
+                 int& iter_num) {
+    std::vector<Junction> junction_vec = GetJunctions(system.exp_rhs_vec);
+    const ConvergenceCriteria& criteria = setting.criteria;
+
+    LuFactor local_lu;
+    LuFactor& lu = setting.lu ? *setting.lu : local_lu;
+    bool refactor =
+        !setting.chord || !lu.valid || lu.linear_version != system.mat_version;
+    double last_update_norm = 0;
+
+    vec result_n = result;
+    vec residual = NewtonResidual(system, result_n);
+    vec scale;
+    double residual_n = arma::norm(residual);
+
+    for (iter_num = 1; iter_num <= setting.max_iter; iter_num++) {
+        double refactor_fraction = 0;
+        if (refactor) {
+            refactor_fraction = FactorizeJacobian(system, result_n, lu, setting.stat);
+            if (refactor_fraction == 0)
+                return false;
+        }
+
+        // In chord mode the Jacobian may be from an earlier iteration or call.
+        vec dx = -1 * lu.Solve(residual);
+        if (setting.stat) {
+            setting.stat->solve_num++;
+            setting.stat->newton_iter_num++;
+        }
+        if (!dx.is_finite()) {
+            lu.valid = false;
+            return false;
+        }
+        double lambda = JunctionStepLimit(junction_vec, result_n, dx);
+
+        vec result_try = result_n + lambda * dx;
+        residual = NewtonResidual(system, result_try, &scale);
+
+        // Both the full Newton update and the residual after it are small enough.
+        if (lambda == 1 &&
+            CheckUpdate(result_n, result_try, system.voltage_num, criteria) &&
+            CheckResidual(residual, scale, system.voltage_num, criteria)) {
+            if (setting.history)
+                setting.history->push_back(IterationNorm(arma::norm(dx, "inf"),
+                                                         arma::norm(residual, "inf"), 1,
+                                                         refactor_fraction));
+            result = result_try;
+            return true;
+        }
+
+        double residual_try = arma::norm(residual);
+        while (residual_try > (1 - ARMIJO_ALPHA * lambda) * residual_n &&
+               lambda > DAMPING_MIN) {
+            lambda /= 2;
+            result_try = result_n + lambda * dx;
+            residual = NewtonResidual(system, result_try);
+            residual_try = arma::norm(residual);
+        }
+
+        double update_norm = arma::norm(dx, "inf");
+        if (setting.history)
+            setting.history->push_back(IterationNorm(
+                update_norm, arma::norm(residual, "inf"), lambda, refactor_fraction));
+
+        // Keep a reused factorization only while the update contracts fast.
+        refactor = !setting.chord || lambda < 1 ||
+                   (iter_num > 1 && update_norm > CHORD_RATE_MAX * last_update_norm);
+        last_update_norm = update_norm;
+
+        result_n = result_try;
+        residual_n = residual_try;
+    }
+    iter_num = setting.max_iter;
+    lu.valid = false;
+    return false;
+}
+
+/**
+ * @brief Gmin stepping. A conductance to ground is added to every node and
+ * reduced decade by decade, each Newton run starting from the last solution.
+ */
+bool GminStepping(const NewtonSystem& system, const NewtonSetting& setting, vec& result,
+                  int& iter_num) {
+    NewtonSystem gmin_system = system;
+    vec x = result;
+    iter_num = 0;
+
+    for (double gmin = GMIN_START; gmin >= GMIN_STOP; gmin /= GMIN_FACTOR) {
+        gmin_system.mat = system.mat;
+        for (int i = 0; i < system.voltage_num; i++)
+            gmin_system.mat(i, i) += gmin;
+        gmin_system.MatChanged();
+
+        int n = 0;
+        bool converged = NewtonSolve(gmin_system, setting, x, n);
+        iter_num += n;
+        if (!converged)
+            return false;
+    }
+
+    // Finally remove gmin
+    int n = 0;
+    bool converged = NewtonSolve(system, setting, x, n);
+    iter_num += n;
+    if (converged)
+        result = x;
+    return converged;
+}
+
+/**
+ * @brief Source stepping. All independent sources are ramped from 0 to their
+ * full value. The step grows after a success and is halved after a failure.
+ */
+bool SourceStepping(const NewtonSystem& system, const NewtonSetting& setting,
+                    vec& result, int& iter_num) {
+    NewtonSystem scaled_system = system;
+    // With all sources off the circuit sits at zero.
+    vec x(system.mat.n_rows, arma::fill::zeros);
+    iter_num = 0;
+
+    double alpha = 0;
+    double step = 0.1;
+    while (alpha < 1) {
+        double next_alpha = std::min(1.0, alpha + step);
+        scaled_system.rhs = next_alpha * system.rhs;
+
+        vec x_try = x;
+        int n = 0;
+        bool converged = NewtonSolve(scaled_system, setting, x_try, n);
+        iter_num += n;
+
+        if (converged) {
+            x = x_try;
+            alpha = next_alpha;
+            step *= 2;
+        } else {
+            step /= 2;
+            if (step < SOURCE_STEP_MIN)
+                return false;
+        }
+    }
+    result = x;
+    return true;
+}
+
+/**
+ * @brief KCL residual F(x) of the system, which is zero at the solution.
+ *
+ * @param system
+ * @param x
+ * @param scale if not null, the magnitude of the terms summed into each row
+ * @return arma::vec
+ */
+vec NewtonResidual(const NewtonSystem& system, const vec& x, vec* scale) {
+    mat jacobian = AddExpTerm(system.exp_analysis_vec, x, system.mat);
+    mat rhs = AddExpTerm(system.exp_rhs_vec, x, system.rhs);
+    if (scale)
+        *scale = arma::abs(jacobian) * arma::abs(x) + arma::abs(vec(rhs));
+    return jacobian * x - rhs;
+}
+
+/**
+ * @brief Pseudo-transient continuation. An artificial capacitor from every node
+ * to ground is integrated with Backward Euler towards the steady state. The
+ * step grows as the residual drops, and once it is small enough Newton on the
+ * original system takes over.
+ */
+bool PseudoTransient(const NewtonSystem& system, const NewtonSetting& setting,
+                     vec& result, int& iter_num, PseudoTranStat& stat) {
+    auto start_time = std::chrono::steady_clock::now();
+
+    NewtonSetting step_setting = setting;
+    step_setting.max_iter = PTRAN_NEWTON_ITER;
+
+    NewtonSystem step_system = system;
+    vec x = result;
+    double h = PTRAN_H_START;
+    double residual = arma::norm(NewtonResidual(system, x), "inf");
+    bool converged = false;
+    iter_num = 0;
+    stat = PseudoTranStat();
+
+    while (stat.step_num < PTRAN_MAX_STEP) {
+        // BE companion model of the artificial capacitor: C/h to ground with
+        // C/h * x_n on the RHS.
+        step_system.mat = system.mat;
+        step_system.rhs = system.rhs;
+        for (int i = 0; i < system.voltage_num; i++) {
+            step_system.mat(i, i) += PTRAN_CAP / h;
+            step_system.rhs(i, 0) += PTRAN_CAP / h * x(i);
+        }
+        step_system.MatChanged();
+
+        vec x_next = x;
+        int n = 0;
+        bool step_converged = NewtonSolve(step_system, step_setting, x_next, n);
+        iter_num += n;
+        stat.step_num++;
+
+        if (!step_converged) {
+            h /= 4;
+            if (h < PTRAN_H_START * 1e-6)
+                break;
+            continue;
+        }
+
+        // Switched evolution relaxation: grow h as the residual drops.
+        double next_residual = arma::norm(NewtonResidual(system, x_next), "inf");
+        h = std::min(PTRAN_H_MAX, h * std::min(10.0, residual / next_residual));
+        x = x_next;
+        residual = next_residual;
+
+        if (residual < PTRAN_HANDOFF || h >= PTRAN_H_MAX) {
+            vec x_newton = x;
+            if (NewtonSolve(system, setting, x_newton, n)) {
+                iter_num += n;
+                x = x_newton;
+                residual = arma::norm(NewtonResidual(system, x), "inf");
+                converged = true;
+                break;
+            }
+            iter_num += n;
+        }
+    }
+
+    stat.residual = residual;
+    stat.time = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                              start_time)
+                    .count();
+    if (converged)
+        result = x;
+    return converged;
+}
+
+/**
+ * @brief Solve the operating point with the convergence-aid ladder:
+ * Newton (or pseudo-transient with .options ptran) -> gmin stepping ->
+ * source stepping -> pseudo-transient.
+ *
+ * @param system
+ * @param setting
+ * @param result initial guess in, solution out
+ * @param report which strategies ran and their iteration counts
+ * @return true: one of the strategies converged
+ */
+bool SolveOperatingPoint(const NewtonSystem& system, const NewtonSetting& setting,
+                         vec& result, ConvergenceReport& report) {
+    report = ConvergenceReport();
+    int iter_num = 0;
+
+    vec x = result;
+    bool converged = false;
+
+    NewtonSetting first_setting = setting;
+    first_setting.history = &report.history;
+    if (setting.pseudo_tran) {
+        converged =
+            PseudoTransient(system, setting, x, iter_num, report.pseudo_tran_stat);
+        report.pseudo_tran_ran = true;
+        report.Add("pseudo-transient", iter_num);
+    } else {
+        converged = NewtonSolve(system, first_setting, x, iter_num);
+        report.Add("newton", iter_num);
+    }
+
+    if (!converged) {
+        x = result;
+        converged = GminStepping(system, setting, x, iter_num);
+        report.Add("gmin stepping", iter_num);
+    }
+
+    if (!converged) {
+        converged = SourceStepping(system, setting, x, iter_num);
+        report.Add("source stepping", iter_num);
+    }
+
+    // Last resort when it was not tried first
+    if (!converged && !report.pseudo_tran_ran) {
+        x = result;
+        converged =
+            PseudoTransient(system, setting, x, iter_num, report.pseudo_tran_stat);
+        report.pseudo_tran_ran = true;
+        report.Add("pseudo-transient", iter_num);
+    }
+
+    report.converged = converged;
+    if (converged) {
+        report.converged_strategy = report.strategy_vec.back();
+        result = x;
+    }
+    return converged;
+}
+
+void PrintConvergenceReport(const ConvergenceReport& report) {
+    if (!report.history.empty())
+        PrintConvergenceHistory(report.history);
+    for (std::size_t i = 0; i < report.strategy_vec.size(); i++)
+        cout << "  " << report.strategy_vec[i] << ": " << report.iteration_vec[i]
+             << " iterations" << endl;
+    if (report.pseudo_tran_ran)
+        cout << "  pseudo-transient: " << report.pseudo_tran_stat.step_num << " steps, "
+             << "residual " << report.pseudo_tran_stat.residual << ", "
+             << report.pseudo_tran_stat.time * 1e3 << " ms" << endl;
+    if (report.converged)
+        cout << "  Converged with " << report.converged_strategy << endl;
+    else
+        cout << "  Failed to converge" << endl;
+}
+
+void PrintRunStatistics(const RunStatistics& stat) {
+    cout << "Run statistics: " << stat.newton_iter_num << " Newton iterations; "
+         << stat.factorization_num << " LU factorizations; ";
+    if (stat.partial_refactor_num > 0)
+        cout << stat.partial_refactor_num << " partial refactorizations ("
+             << 100 * stat.recomputed_fraction_sum / stat.partial_refactor_num
+             << "% of the columns on average); ";
+    cout << stat.solve_num << " solves" << endl;
+}
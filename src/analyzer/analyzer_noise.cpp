@@ -0,0 +1,162 @@
+/**
+ * @file analyzer_noise.cpp
+ * @brief Small-signal noise analysis with one adjoint solve per frequency
+ * @date 2026-10-19
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include "analyzer.h"
+
+using arma::cx_double;
+using arma::cx_mat;
+using arma::cx_vec;
+using arma::mat;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::setw;
+using std::vector;
+
+constexpr double BOLTZMANN = 1.380649e-23;
+constexpr double ELECTRON_CHARGE = 1.602176634e-19;
+constexpr double NOISE_TEMPERATURE = 300.15;  // 27 C
+
+/**
+ * @brief Resistor thermal noise 4kT/R and diode shot noise 2q|I_d| at the
+ * operating point, as current sources across the devices.
+ */
+static vector<NoiseSource> GetNoiseSources(const Circuit& circuit,
+                                           const OperatingPoint& op) {
+    auto index_of = [&op](NodeName node) { return op.node_index.value(node, -1); };
+
+    vector<NoiseSource> source_vec;
+    for (Res res : circuit.res_vec)
+        source_vec.push_back(NoiseSource{res.name.toStdString(), index_of(res.node_1),
+                                         index_of(res.node_2),
+                                         4 * BOLTZMANN * NOISE_TEMPERATURE / res.value});
+
+    for (const Junction& junction : GetJunctions(op.system.exp_rhs_vec)) {
+        double i_d = junction.i_sat *
+                     (LimitedExp(JunctionVoltage(junction, op.result) / junction.vt) - 1);
+        const Diode& diode = circuit.diode_vec[junction.diode_index];
+        source_vec.push_back(NoiseSource{diode.name.toStdString(),
+                                         junction.node_1_index, junction.node_2_index,
+                                         2 * ELECTRON_CHARGE * fabs(i_d)});
+    }
+    return source_vec;
+}
+
+/**
+ * @brief Output and input-referred noise spectra. At each frequency one
+ * transposed solve (G + jwC)^T * lambda = c gives the transfer from every
+ * noise source to the output at once, instead of one solve per source. The
+ * frequencies are split over the hardware threads.
+ *
+ * @param noise_analysis
+ */
+void Analyzer::DoNoiseAnalysis(const NoiseAnalysis noise_analysis) {
+    mat G, C;
+    QHash<NodeName, int> node_index;
+    if (!GetPencil(G, C, node_index)) {
+        cout << "Operating point failed, no noise" << endl;
+        return;
+    }
+    vec c, u;
+    if (!GetTransferStamps(noise_analysis.transfer, node_index, c, u))
+        return;
+
+    // GetPencil has already solved the operating point if it is needed.
+    OperatingPoint linear_op;
+    linear_op.node_index = node_index;
+    const OperatingPoint& op =
+        circuit.diode_vec.empty() ? linear_op : GetOperatingPoint();
+    vector<NoiseSource> source_vec = GetNoiseSources(circuit, op);
+
+    vector<double> freq_vec = GetScanFrequencies(noise_analysis.sweep);
+    const int freq_num = freq_vec.size();
+    const int source_num = source_vec.size();
+    mat contribution_mat(freq_num, source_num, arma::fill::zeros);
+    vec gain(freq_num, arma::fill::zeros);  // |H_in|^2
+    const cx_vec c_cx = arma::conv_to<cx_vec>::from(c);
+    const cx_vec u_cx = arma::conv_to<cx_vec>::from(u);
+
+    auto worker = [&](int first, int stride) {
+        for (int i = first; i < freq_num; i += stride) {
+            cx_mat A(G, 2 * M_PI * freq_vec[i] * C);
+            cx_vec lambda;
+            if (!arma::solve(lambda, cx_mat(A.st()), c_cx)) {
+                contribution_mat.row(i).fill(arma::datum::nan);
+                gain(i) = arma::datum::nan;
+                continue;
+            }
+
+            auto transfer = [&lambda](int index_1, int index_2) {
+                cx_double h = 0;
+                if (index_1 >= 0)
+                    h += lambda(index_1);
+                if (index_2 >= 0)
+                    h -= lambda(index_2);
+                return h;
+            };
+            for (int k = 0; k < source_num; k++) {
+                double h = std::abs(transfer(source_vec[k].node_1_index,
+                                             source_vec[k].node_2_index));
+                contribution_mat(i, k) = h * h * source_vec[k].psd;
+            }
+            double h_in = std::abs(arma::dot(lambda, u_cx));
+            gain(i) = h_in * h_in;
+        }
+    };
+
+    int thread_num = std::max(1u, std::thread::hardware_concurrency());
+    thread_num = std::min(thread_num, std::max(freq_num, 1));
+    vector<std::thread> thread_vec;
+    for (int t = 1; t < thread_num; t++)
+        thread_vec.push_back(std::thread(worker, t, thread_num));
+    worker(0, thread_num);
+    for (std::thread& thread : thread_vec)
+        thread.join();
+
+    vector<std::string> name_vec;
+    for (const NoiseSource& source : source_vec)
+        name_vec.push_back(source.name);
+    vec output_psd = arma::sum(contribution_mat, 1);
+    // The input-referred noise is undefined where the input does not reach the
+    // output.
+    vec input_psd(freq_num);
+    int undefined_num = 0;
+    for (int i = 0; i < freq_num; i++) {
+        if (gain(i) > 0 && std::isfinite(gain(i))) {
+            input_psd(i) = output_psd(i) / gain(i);
+        } else {
+            input_psd(i) = arma::datum::nan;
+            undefined_num++;
+        }
+    }
+    noise_result =
+        NoiseResult{freq_vec, name_vec, contribution_mat, output_psd, input_psd};
+
+    cout << "Noise analysis (" << freq_num << " adjoint solves on " << thread_num
+         << " threads)" << endl;
+    cout << setw(14) << "freq" << setw(14) << "onoise" << setw(14) << "inoise"
+         << "  (per sqrt(Hz))" << endl;
+    for (int i = 0; i < freq_num; i++)
+        cout << setw(14) << freq_vec[i] << setw(14) << sqrt(output_psd(i)) << setw(14)
+             << sqrt(input_psd(i)) << endl;
+    if (undefined_num > 0)
+        cout << undefined_num << " points without gain from the input, no inoise there"
+             << endl;
+
+    // Total output noise of each source over the band
+    if (freq_num > 1) {
+        vec freq(freq_vec);
+        cout << "Integrated output noise contributions (V^2 or A^2):" << endl;
+        for (int k = 0; k < source_num; k++)
+            cout << setw(14) << name_vec[k] << setw(14)
+                 << arma::as_scalar(arma::trapz(freq, contribution_mat.col(k))) << endl;
+        cout << setw(14) << "total" << setw(14)
+             << arma::as_scalar(arma::trapz(freq, output_psd)) << endl;
+    }
+}
@@ -0,0 +1,154 @@
+/**
+ * @file analyzer_opcache.cpp
+ * @brief Operating points kept on disk as warm starts for later runs
+ * @date 2026-10-19
+ */
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileInfoList>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTextStream>
+
+#include "analyzer.h"
+
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::vector;
+
+// Cached operating points beyond this many files are dropped, oldest first.
+constexpr int OP_CACHE_MAX_FILES = 100;
+
+/**
+ * @brief Hash of the topology of the circuit: the name and nodes of every
+ * device, in any order. Values are left out, so a netlist whose values were
+ * edited keeps its hash and its cached operating point. A hit is therefore
+ * only a starting guess, the Newton solve from it gives the answer.
+ *
+ * @param circuit
+ * @return hex SHA-1
+ */
+QString CircuitHash(const Circuit& circuit) {
+    QStringList line_list;
+    auto add = [&line_list](const QString kind, const BaseDevice& device) {
+        line_list << kind + " " + device.name + " " + device.node_1 + " " + device.node_2;
+    };
+    for (Vsrc vsrc : circuit.vsrc_vec)
+        add("v", vsrc);
+    for (Isrc isrc : circuit.isrc_vec)
+        add("i", isrc);
+    for (Res res : circuit.res_vec)
+        add("r", res);
+    for (Cap cap : circuit.cap_vec)
+        add("c", cap);
+    for (Ind ind : circuit.ind_vec)
+        add("l", ind);
+    for (VCCS vccs : circuit.vccs_vec) {
+        add("g", vccs);
+        line_list.last() += " " + vccs.ctrl_node_1 + " " + vccs.ctrl_node_2;
+    }
+    for (VCVS vcvs : circuit.vcvs_vec) {
+        add("e", vcvs);
+        line_list.last() += " " + vcvs.ctrl_node_1 + " " + vcvs.ctrl_node_2;
+    }
+    for (Diode diode : circuit.diode_vec)
+        line_list << "d " + diode.name + " " + diode.node_1 + " " + diode.node_2 + " " +
+                         diode.model;
+    line_list.sort();
+
+    QByteArray text = line_list.join("\n").toUtf8();
+    return QString::fromLatin1(
+        QCryptographicHash::hash(text, QCryptographicHash::Sha1).toHex());
+}
+
+/**
+ * @brief The cache file of a circuit, `name value` per line.
+ *
+ * @param circuit
+ * @return empty when the platform has no cache location
+ */
+QString OperatingPointCachePath(const Circuit& circuit) {
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (dir.isEmpty())
+        return QString();
+    return dir + "/op/" + CircuitHash(circuit) + ".op";
+}
+
+/**
+ * @brief Keep only the OP_CACHE_MAX_FILES most recently written cache files.
+ *
+ * @param dir_path
+ */
+static void EvictOperatingPoints(const QString dir_path) {
+    QFileInfoList file_list =
+        QDir(dir_path).entryInfoList(QStringList("*.op"), QDir::Files, QDir::Time);
+    for (int i = OP_CACHE_MAX_FILES; i < file_list.size(); i++)
+        QFile::remove(file_list[i].absoluteFilePath());
+}
+
+/**
+ * @brief Replace the unknowns of result that have a cached value under the
+ * same name. Unknowns new to the circuit keep their value.
+ *
+ * @param node_vec the unknowns of result, gnd removed
+ * @param result
+ * @return false: no cache for this circuit
+ */
+bool Analyzer::LoadOperatingPoint(const vector<NodeName>& node_vec, vec& result) {
+    QString path = OperatingPointCachePath(circuit);
+    if (!options.op_cache || path.isEmpty())
+        return false;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    QHash<NodeName, int> node_index = GetNodeIndex(node_vec);
+    QTextStream text_stream(&file);
+    int match_num = 0;
+    while (!text_stream.atEnd()) {
+        QStringList name_value = text_stream.readLine().split(" ");
+        int index = node_index.value(name_value[0], -1);
+        bool ok = false;
+        double value = name_value.length() == 2 ? name_value[1].toDouble(&ok) : 0;
+        if (index >= 0 && ok) {
+            result(index) = value;
+            match_num++;
+        }
+    }
+    if (match_num == 0)
+        return false;
+    cout << "Warm start from the cached operating point (" << match_num << " of "
+         << node_vec.size() << " unknowns)" << endl;
+    return true;
+}
+
+/**
+ * @brief Keep a converged operating point for the next run of this circuit,
+ * with .options opcache.
+ *
+ * @param node_vec the unknowns of result, gnd removed
+ * @param result
+ */
+void Analyzer::SaveOperatingPoint(const vector<NodeName>& node_vec, const vec& result) {
+    QString path = OperatingPointCachePath(circuit);
+    if (!options.op_cache || path.isEmpty())
+        return;
+    QFile file(path);
+    if (!QDir().mkpath(QFileInfo(path).path()) ||
+        !file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        cout << "Cannot write the operating point cache " << path << endl;
+        return;
+    }
+
+    QTextStream text_stream(&file);
+    for (std::size_t i = 0; i < node_vec.size(); i++)
+        text_stream << node_vec[i] << " " << QString::number(result(i), 'g', 17) << "\n";
+    text_stream.flush();
+    file.close();
+    cout << "Operating point cached in " << path << endl;
+    EvictOperatingPoints(QFileInfo(path).path());
+}
@@ -0,0 +1,149 @@
+/**
+ * @file analyzer_parareal.cpp
+ * @brief Parareal parallel-in-time transient
+ * @date 2026-10-19
+ */
+
+#include <algorithm>
+#include <map>
+#include <thread>
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::vector;
+
+// Parareal cuts the run into PARAREAL_SLICE_NUM slices whatever the thread
+// count, and the coarse propagator steps PARAREAL_COARSENING fine steps at once.
+constexpr int PARAREAL_SLICE_NUM = 32;
+constexpr int PARAREAL_COARSENING = 10;
+
+/**
+ * @brief Transient by Parareal. The run is cut into PARAREAL_SLICE_NUM time
+ * slices, so the answer does not depend on the machine. The coarse
+ * propagator G takes Backward Euler steps of PARAREAL_COARSENING * t_step over
+ * a slice, the fine one F the usual t_step stepping. Each iteration runs F on
+ * all slices in parallel from the current slice starts U_j, then corrects them
+ * in order, U_{j+1} = G(U_j^new) + F(U_j) - G(U_j). After k iterations the
+ * first k slices are exact, and it stops once no slice start moves by more
+ * than the Newton tolerance.
+ *
+ * @param tran_analysis
+ */
+void Analyzer::DoPararealTranAnalysis(const TranAnalysis tran_analysis) {
+    const double t_start = tran_analysis.t_start;
+    const double h = tran_analysis.t_step;
+    const int scan_num = (tran_analysis.t_stop - t_start) / h;
+    const int voltage_num = circuit.node_vec.size() - 1;
+
+    const int slice_num = std::max(1, std::min(scan_num, PARAREAL_SLICE_NUM));
+    int thread_num = std::max(1u, std::thread::hardware_concurrency());
+    thread_num = std::min(thread_num, slice_num);
+    vector<int> bound(slice_num + 1);
+    for (int j = 0; j <= slice_num; j++)
+        bound[j] = static_cast<long>(j) * scan_num / slice_num;
+
+    // One fine stepper with its own counters per thread
+    vector<TranStepper> fine_vec(thread_num);
+    vector<RunStatistics> stat_vec(thread_num);
+    for (int t = 0; t < thread_num; t++) {
+        if (!InitTranStepper(h, fine_vec[t]))
+            return;
+        fine_vec[t].newton_setting.stat = &stat_vec[t];
+    }
+    // A slice of `steps` fine steps takes coarse_num(steps) equal coarse steps.
+    auto coarse_num = [](int steps) {
+        return std::max(1, (steps + PARAREAL_COARSENING - 1) / PARAREAL_COARSENING);
+    };
+    std::map<int, TranStepper> coarse_map;  // By slice length in steps
+    for (int j = 0; j < slice_num; j++) {
+        int steps = bound[j + 1] - bound[j];
+        if (!coarse_map.count(steps) &&
+            !InitTranStepper(steps * h / coarse_num(steps), coarse_map[steps]))
+            return;
+    }
+    auto coarse = [&](int j, const vec& x) {
+        const int steps = bound[j + 1] - bound[j];
+        TranStepper& stepper = coarse_map[steps];
+        vec x_prev = x, x_next;
+        for (int i = 1; i <= coarse_num(steps); i++) {
+            int iter_num = 0;
+            TranStep(stepper, t_start + bound[j] * h + i * stepper.h, x_prev, x_next,
+                     iter_num);
+            x_prev = x_next;
+        }
+        return x_prev;
+    };
+
+    const int size = fine_vec[0].MNA.n_rows;
+    mat tran_result_mat(size, scan_num + 1, arma::fill::zeros);
+    tran_result_mat.col(0) = GetTranInitialState(tran_analysis, fine_vec[0].node_vec);
+    vector<vec> U(slice_num + 1), G_old(slice_num), F(slice_num);
+    U[0] = tran_result_mat.col(0);
+    for (int j = 0; j < slice_num; j++) {
+        G_old[j] = coarse(j, U[j]);
+        U[j + 1] = G_old[j];
+    }
+
+    const ConvergenceCriteria criteria(options);
+    vector<int> fail_num(thread_num, 0);
+    int first = 0, iter_num = 0;
+    bool converged = false;
+    while (!converged && first < slice_num) {
+        iter_num++;
+
+        // Slices before `first` have exact starts and final trajectories.
+        auto worker = [&](int t, int stride) {
+            TranStepper& fine = fine_vec[t];
+            for (int j = first + t; j < slice_num; j += stride) {
+                vec x = U[j];
+                for (int n = bound[j]; n < bound[j + 1]; n++) {
+                    vec x_next;
+                    int newton_iter = 0;
+                    if (!TranStep(fine, t_start + (n + 1) * h, x, x_next, newton_iter))
+                        fail_num[t]++;
+                    tran_result_mat.col(n + 1) = x_next;
+                    x = x_next;
+                }
+                F[j] = x;
+            }
+        };
+        vector<std::thread> thread_vec;
+        for (int t = 1; t < thread_num; t++)
+            thread_vec.push_back(std::thread(worker, t, thread_num));
+        worker(0, thread_num);
+        for (std::thread& thread : thread_vec)
+            thread.join();
+
+        // Sequential coarse correction
+        converged = true;
+        vec x = U[first];
+        for (int j = first; j < slice_num; j++) {
+            vec g = coarse(j, x);
+            x = g + F[j] - G_old[j];
+            G_old[j] = g;
+            converged = converged && CheckUpdate(U[j + 1], x, voltage_num, criteria);
+            U[j + 1] = x;
+        }
+        first++;
+    }
+
+    for (int t = 0; t < thread_num; t++) {
+        run_stat.Add(stat_vec[t]);
+        if (fail_num[t] > 0)
+            cout << "Newton failed to converge in " << fail_num[t] << " fine steps"
+                 << endl;
+    }
+
+    vector<double> time_point_vec;
+    for (int n = 0; n <= scan_num; n++)
+        time_point_vec.push_back(t_start + n * h);
+    tran_result = TranResult{tran_result_mat, time_point_vec, fine_vec[0].node_vec};
+
+    cout << "Parareal: " << slice_num << " slices on " << thread_num << " threads, "
+         << iter_num << " iterations, "
+         << (converged ? "converged" : "exact after one iteration per slice") << endl;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file analyzer_partition.cpp
+ * @brief Splitting the transient system into loosely coupled blocks
+ * @date 2026-10-19
+ */
+
+#include <functional>
+#include <numeric>
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::uvec;
+
+/**
+ * @brief Group the unknowns of A into blocks. Two unknowns are in the same
+ * block when they are strongly coupled, |a_ij| or |a_ji| above `coupling`
+ * times the smaller of |a_ii| and |a_jj|, or when an ExpTerm ties them. A
+ * branch row with a zero diagonal always joins the nodes it touches.
+ *
+ * @param A
+ * @param exp_term_vec diodes, in reduced indices
+ * @param coupling
+ * @return the unknowns of each block, ascending
+ */
+std::vector<uvec> PartitionUnknowns(const mat& A,
+                                    const std::vector<ExpTerm>& exp_term_vec,
+                                    const double coupling) {
+    const int size = A.n_rows;
+    std::vector<int> parent(size);
+    std::iota(parent.begin(), parent.end(), 0);
+    std::function<int(int)> find = [&](int i) {
+        return parent[i] == i ? i : parent[i] = find(parent[i]);
+    };
+    auto unite = [&](int i, int j) {
+        if (i >= 0 && j >= 0)
+            parent[find(i)] = find(j);
+    };
+
+    for (int i = 0; i < size; i++) {
+        for (int j = i + 1; j < size; j++) {
+            double a = std::max(fabs(A(i, j)), fabs(A(j, i)));
+            if (a > 0 && a >= coupling * std::min(fabs(A(i, i)), fabs(A(j, j))))
+                unite(i, j);
+        }
+    }
+    for (const ExpTerm& term : exp_term_vec) {
+        unite(term.node_1_index, term.node_2_index);
+        unite(term.row_index, term.node_1_index);
+        unite(term.row_index, term.node_2_index);
+    }
+
+    std::vector<uvec> block_vec;
+    std::vector<int> block_of(size, -1);
+    std::vector<std::vector<arma::uword>> member_vec;
+    for (int i = 0; i < size; i++) {
+        int root = find(i);
+        if (block_of[root] < 0) {
+            block_of[root] = member_vec.size();
+            member_vec.push_back({});
+        }
+        member_vec[block_of[root]].push_back(i);
+    }
+    for (const auto& member : member_vec)
+        block_vec.push_back(uvec(member));
+    return block_vec;
+}
+
+/**
+ * @brief The ExpTerms whose row lies in `index`, renumbered to positions in
+ * `index`. Columns of RHS terms stay 0.
+ *
+ * @param exp_term_vec
+ * @param index ascending unknowns of a block
+ * @param rhs true: RHS terms
+ */
+std::vector<ExpTerm> RestrictExpTerms(const std::vector<ExpTerm>& exp_term_vec,
+                                      const uvec& index, const bool rhs) {
+    auto local = [&index](int i) {
+        if (i < 0)
+            return -1;
+        uvec found = arma::find(index == static_cast<arma::uword>(i), 1);
+        return found.is_empty() ? -1 : static_cast<int>(found(0));
+    };
+
+    std::vector<ExpTerm> local_vec;
+    for (ExpTerm term : exp_term_vec) {
+        int row = local(term.row_index);
+        if (row < 0)
+            continue;
+        term.row_index = row;
+        if (!rhs)
+            term.col_index = local(term.col_index);
+        term.node_1_index = local(term.node_1_index);
+        term.node_2_index = local(term.node_2_index);
+        local_vec.push_back(term);
+    }
+    return local_vec;
+}
@@ -8,10 +8,14 @@
 #include "analyzer.h"
 
 using std::complex;
+using std::cout;
+using std::endl;
 
-void DcPlot(DcResult result, std::vector<PrintVariable> print_variable_vec) {
+void DcPlot(DcResult result, std::vector<PrintVariable> print_variable_vec,
+            const bool print_only) {
     std::vector<QVector<double>> x_vec, y_vec;
     std::vector<NodeName> name_vec;
+    std::vector<QString> label_vec;
 
     for (auto print_variable : print_variable_vec) {
         NodeName node = print_variable.node;
@@ -27,14 +31,20 @@ void DcPlot(DcResult result, std::vector<PrintVariable> print_variable_vec) {
         x_vec.push_back(x);
         y_vec.push_back(y);
         name_vec.push_back(node);
+        label_vec.push_back(PrintLabel(print_variable, false));
     }
 
-    Plot(x_vec, y_vec, name_vec, QString("Vsrc"), QString("Value"), false, false);
+    if (print_only)
+        Print(x_vec, y_vec, label_vec, QString("Vsrc"));
+    else
+        Plot(x_vec, y_vec, name_vec, QString("Vsrc"), QString("Value"), false, false);
 }
 
-void AcPlot(AcResult result, std::vector<PrintVariable> print_variable_vec) {
+void AcPlot(AcResult result, std::vector<PrintVariable> print_variable_vec,
+            const bool print_only) {
     std::vector<QVector<double>> x_vec, y_vec;
     std::vector<NodeName> name_vec;
+    std::vector<QString> label_vec;
 
     for (auto print_variable : print_variable_vec) {
         NodeName node = print_variable.node;
@@ -73,14 +83,21 @@ void AcPlot(AcResult result, std::vector<PrintVariable> print_variable_vec) {
         x_vec.push_back(freq);
         y_vec.push_back(y);
         name_vec.push_back(node);
+        label_vec.push_back(PrintLabel(print_variable, true));
     }
 
-    Plot(x_vec, y_vec, name_vec, QString("Frequency"), QString("Value"), true, false);
+    if (print_only)
+        Print(x_vec, y_vec, label_vec, QString("Frequency"));
+    else
+        Plot(x_vec, y_vec, name_vec, QString("Frequency"), QString("Value"), true,
+             false);
 }
 
-void TranPlot(TranResult result, std::vector<PrintVariable> print_variable_vec) {
+void TranPlot(TranResult result, std::vector<PrintVariable> print_variable_vec,
+              const bool print_only) {
     std::vector<QVector<double>> x_vec, y_vec;
     std::vector<NodeName> name_vec;
+    std::vector<QString> label_vec;
 
     for (auto print_variable : print_variable_vec) {
         NodeName node = print_variable.node;
@@ -97,9 +114,42 @@ void TranPlot(TranResult result, std::vector<PrintVariable> print_variable_vec)
         x_vec.push_back(t);
         y_vec.push_back(y);
         name_vec.push_back(node);
+        label_vec.push_back(PrintLabel(print_variable, false));
     }
 
-    Plot(x_vec, y_vec, name_vec, QString("Time"), QString("Value"), false, false);
+    if (print_only)
+        Print(x_vec, y_vec, label_vec, QString("Time"));
+    else
+        Plot(x_vec, y_vec, name_vec, QString("Time"), QString("Value"), false, false);
+}
+
+/**
+ * @brief The name of a .print variable as it was written, e.g. v(2), and for
+ * AC with the part that is printed, e.g. vm(2) or vp(2).
+ *
+ * @param print_variable
+ * @param ac
+ */
+QString PrintLabel(const PrintVariable print_variable, const bool ac) {
+    const QString ac_type_lookup[] = {"m", "r", "i", "p", "db"};
+    QString prefix = print_variable.print_i_v == V ? "v" : "i";
+    if (ac)
+        prefix += ac_type_lookup[print_variable.analysis_variable_type];
+    return prefix + "(" + print_variable.node + ")";
+}
+
+/**
+ * @brief Text form of Plot, one `label = y at x_label = x` line per point.
+ */
+void Print(std::vector<QVector<double>> x_vec, std::vector<QVector<double>> y_vec,
+           std::vector<QString> label_vec, QString x_label) {
+    x_label = x_label.toLower();
+    for (std::size_t i = 0; i < x_vec.size(); i++) {
+        int point_num = std::min(x_vec[i].size(), y_vec[i].size());
+        for (int j = 0; j < point_num; j++)
+            cout << label_vec[i] << " = " << y_vec[i][j] << " at " << x_label << " = "
+                 << x_vec[i][j] << endl;
+    }
 }
 
 // Plot with x and y
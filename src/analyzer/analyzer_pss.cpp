@@ -0,0 +1,127 @@
+/**
+ * @file analyzer_pss.cpp
+ * @brief Periodic steady state by the shooting method
+ * @date 2026-10-19
+ */
+
+#include <algorithm>
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::uvec;
+using arma::vec;
+using std::cout;
+using std::endl;
+
+// Shooting Newton for .pss stops after this many period integrations.
+constexpr int PSS_MAX_ITER = 50;
+
+/**
+ * @brief Periodic steady state by Newton shooting on the transient stepper.
+ * The state s (capacitor voltages and inductor currents, the unknowns a step
+ * takes from the previous one) is mapped over one period to Phi(s). Along the
+ * period the sensitivity S = dx/ds is carried with the step Jacobians,
+ * J * S_{n+1} = RHS_gen * S_n, which gives the monodromy matrix M = dPhi/ds,
+ * and each iteration solves (M - I) * ds = s - Phi(s). J is not factorized
+ * again: each step reuses the LU its Newton solve converged with.
+ *
+ * @param pss_analysis
+ */
+void Analyzer::DoPssAnalysis(const PssAnalysis pss_analysis) {
+    int step_num = std::round(pss_analysis.period / pss_analysis.t_step);
+    step_num = std::max(step_num, 1);
+    const double h = pss_analysis.period / step_num;
+
+    TranStepper stepper;
+    if (!InitTranStepper(h, stepper))
+        return;
+    const int size = stepper.MNA.n_rows;
+
+    uvec state_index = arma::find(arma::any(stepper.RHS_gen, 0));
+    const int state_num = state_index.n_elem;
+    // Node voltages come first, so they stay first in the state.
+    const int state_voltage_num =
+        arma::accu(state_index < static_cast<arma::uword>(circuit.node_vec.size() - 1));
+
+    // J * S_{n+1} = rhs with the factorization the step converged with. On the
+    // Schur path it is the one of the reduced system, and the linear rows are
+    // eliminated as in SetSchurRhs and RecoverSchurSolution.
+    auto solve_step_jacobian = [&stepper](const mat& rhs) {
+        if (!stepper.use_schur)
+            return mat(stepper.lu.Solve(rhs));
+        const SchurSystem& schur = stepper.schur;
+        mat Y = schur.linear_lu.Solve(mat(rhs.rows(schur.linear_index)));
+        mat S_N = stepper.lu.Solve(mat(rhs.rows(schur.nonlinear_index) - schur.A_NL * Y));
+        mat S(rhs.n_rows, rhs.n_cols);
+        S.rows(schur.nonlinear_index) = S_N;
+        S.rows(schur.linear_index) = Y - schur.Z * S_N;
+        return S;
+    };
+
+    vec x_0(size, arma::fill::zeros);
+    mat waveform(size, step_num + 1, arma::fill::zeros);
+    bool converged = false;
+    bool step_failed = false;
+    double error = 0;
+    int iter_num = 0;
+    for (iter_num = 1; iter_num <= PSS_MAX_ITER; iter_num++) {
+        mat S(size, state_num, arma::fill::zeros);
+        for (int k = 0; k < state_num; k++)
+            S(state_index(k), k) = 1;
+
+        waveform.col(0) = x_0;
+        for (int i = 0; i < step_num; i++) {
+            vec x_next;
+            int newton_iter = 0;
+            if (!TranStep(stepper, (i + 1) * h, waveform.col(i), x_next, newton_iter) ||
+                !stepper.lu.valid) {
+                cout << "Newton failed to converge at t = " << (i + 1) * h << endl;
+                step_failed = true;
+                break;
+            }
+            S = solve_step_jacobian(stepper.RHS_gen * S);
+            run_stat.solve_num++;
+            waveform.col(i + 1) = x_next;
+        }
+        if (step_failed)
+            break;
+
+        vec s = x_0(state_index);
+        vec residual = vec(waveform.col(step_num))(state_index) - s;
+        error = state_num > 0 ? arma::norm(residual, "inf") : 0;
+        converged = CheckUpdate(s, s + residual, state_voltage_num,
+                                stepper.newton_setting.criteria);
+        if (converged)
+            break;
+
+        // Shooting Newton step
+        mat monodromy = S.rows(state_index);
+        vec ds;
+        if (!arma::solve(ds, mat(monodromy - arma::eye(state_num, state_num)),
+                         vec(-1 * residual))) {
+            cout << "Shooting Newton: singular monodromy matrix" << endl;
+            break;
+        }
+        // The end point is the best guess for the non-state unknowns.
+        x_0 = waveform.col(step_num);
+        x_0(state_index) = s + ds;
+    }
+
+    if (step_failed) {
+        cout << "Shooting iteration " << iter_num << " failed, no periodic steady state"
+             << endl;
+        return;
+    }
+    cout << "Periodic steady state with period " << pss_analysis.period << ": "
+         << (converged ? "converged" : "not converged") << " after " << iter_num
+         << " shooting iterations (" << step_num << " steps each), periodicity error "
+         << error << endl;
+
+    // The start of the period is consistent only through the end point.
+    waveform.col(0) = waveform.col(step_num);
+    std::vector<double> time_point_vec;
+    for (int i = 0; i <= step_num; i++)
+        time_point_vec.push_back(i * h);
+    tran_result = TranResult{waveform, time_point_vec, stepper.node_vec};
+}
@@ -0,0 +1,221 @@
+/**
+ * @file analyzer_pz.cpp
+ * @brief Pole-zero analysis on the G + sC pencil
+ * @date 2026-10-19
+ */
+
+#include <algorithm>
+
+#include "analyzer.h"
+
+using arma::cx_double;
+using arma::cx_mat;
+using arma::cx_vec;
+using arma::mat;
+using arma::span;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::setw;
+
+// Pole-zero analysis uses QZ up to this many unknowns and shift-invert
+// Arnoldi for the PZ_POLE_NUM roots nearest to the origin above it. Roots
+// larger than PZ_INFINITY are the infinite ones of a singular C. A Ritz value
+// is reported only when its residual is within PZ_RITZ_TOL of its size.
+constexpr int PZ_DENSE_MAX = 200;
+constexpr int PZ_POLE_NUM = 10;
+constexpr int PZ_ARNOLDI_DIM = 40;
+constexpr double PZ_INFINITY = 1e15;
+constexpr double PZ_RITZ_TOL = 1e-8;
+
+// Keep the finite roots of the pencil, nearest to the origin first.
+static cx_vec FiniteRoots(const cx_vec& root_vec) {
+    std::vector<cx_double> finite_vec;
+    for (cx_double s : root_vec)
+        if (std::isfinite(std::abs(s)) && std::abs(s) < PZ_INFINITY)
+            finite_vec.push_back(s);
+    std::sort(finite_vec.begin(), finite_vec.end(),
+              [](cx_double a, cx_double b) { return std::abs(a) < std::abs(b); });
+    return cx_vec(finite_vec);
+}
+
+/**
+ * @brief All the finite s with det(A + s * B) = 0 by the QZ algorithm.
+ */
+static cx_vec DensePencilRoots(const mat& A, const mat& B) {
+    cx_vec eigval;
+    cx_mat eigvec;
+    if (!arma::eig_pair(eigval, eigvec, A, mat(-1 * B)))
+        return cx_vec();
+    return FiniteRoots(eigval);
+}
+
+/**
+ * @brief The `num` roots of det(A + s * B) = 0 nearest to the shift by
+ * shift-invert Arnoldi: (A + sigma * B)^{-1} * B has the eigenvalues
+ * 1 / (sigma - s), so the roots near sigma dominate the Krylov space. Only
+ * the Ritz values that passed the residual test are returned.
+ */
+static cx_vec ArnoldiPencilRoots(const mat& A, const mat& B, const int num) {
+    const int n = A.n_rows;
+    LuFactor lu;
+    double sigma = 0;
+    // A is singular when there is a root at the origin, move the shift off it.
+    if (!lu.Factorize(A)) {
+        sigma = 1;
+        if (!lu.Factorize(mat(A + sigma * B)))
+            return cx_vec();
+    }
+
+    int m = std::min(PZ_ARNOLDI_DIM, n);
+    mat V(n, m + 1, arma::fill::zeros);
+    mat H(m + 1, m, arma::fill::zeros);
+    V.col(0) = arma::linspace<vec>(1, 2, n);
+    V.col(0) /= arma::norm(V.col(0));
+
+    for (int j = 0; j < m; j++) {
+        vec w = lu.Solve(B * V.col(j));
+        // Modified Gram-Schmidt, repeated once for stability
+        for (int pass = 0; pass < 2; pass++) {
+            for (int i = 0; i <= j; i++) {
+                double h = arma::dot(V.col(i), w);
+                H(i, j) += h;
+                w -= h * V.col(i);
+            }
+        }
+        H(j + 1, j) = arma::norm(w);
+        if (H(j + 1, j) < 1e-12 * arma::norm(H.col(j))) {
+            m = j + 1;  // Invariant subspace found
+            break;
+        }
+        V.col(j + 1) = w / H(j + 1, j);
+    }
+
+    // The Ritz pair (mu, V * y) leaves the residual |h_{m+1,m} * y_m|.
+    cx_vec mu;
+    cx_mat Y;
+    if (!arma::eig_gen(mu, Y, mat(H(span(0, m - 1), span(0, m - 1)))))
+        return cx_vec();
+    const double h_next = H(m, m - 1);
+    std::vector<cx_double> root_vec;
+    int unconverged_num = 0;
+    for (int i = 0; i < m; i++) {
+        if (std::abs(mu(i)) <= 1e-12)
+            continue;
+        double residual = std::abs(h_next * Y(m - 1, i)) / arma::norm(Y.col(i));
+        if (residual <= PZ_RITZ_TOL * std::abs(mu(i)))
+            root_vec.push_back(sigma - 1.0 / mu(i));
+        else
+            unconverged_num++;
+    }
+    if (unconverged_num > 0)
+        cout << "Arnoldi: " << unconverged_num << " unconverged roots left out" << endl;
+
+    cx_vec finite_vec = FiniteRoots(cx_vec(root_vec));
+    if (static_cast<int>(finite_vec.n_elem) > num)
+        finite_vec = finite_vec.head(num);
+    return finite_vec;
+}
+
+/**
+ * @brief G and C of the linear part of the reduced MNA system, built from
+ * GetAnalysisMatrix at w = 1.
+ *
+ * @param G
+ * @param C
+ * @param node_vec of the reduced system
+ * @param junction_vec the diodes, left out of G and C
+ */
+void Analyzer::GetLinearPencil(mat& G, mat& C, std::vector<NodeName>& node_vec,
+                               std::vector<Junction>& junction_vec) {
+    AnalysisMatrix analysis_matrix = GetAnalysisMatrix(1 / (2 * M_PI));
+    int node_num = analysis_matrix.node_vec.size();
+
+    // `reduced` means remove the 0(gnd) node.
+    cx_mat reduced_mat = analysis_matrix.linear_analysis_mat(span(1, node_num - 1),
+                                                             span(1, node_num - 1));
+    G = arma::real(reduced_mat);
+    C = arma::imag(reduced_mat);
+
+    node_vec = analysis_matrix.node_vec;
+    node_vec.erase(node_vec.begin());
+    junction_vec = GetJunctions(analysis_matrix.exp_rhs_vec);
+}
+
+/**
+ * @brief G and C of the reduced MNA system, so that the small-signal system is
+ * (G + s * C) * x = b. Diodes enter with their small-signal model at the
+ * operating point.
+ *
+ * @param G
+ * @param C
+ * @param node_index of the reduced system
+ * @return false: the operating point failed
+ */
+bool Analyzer::GetPencil(mat& G, mat& C, QHash<NodeName, int>& node_index) {
+    std::vector<NodeName> reduced_node_vec;
+    std::vector<Junction> junction_vec;
+    GetLinearPencil(G, C, reduced_node_vec, junction_vec);
+    node_index = GetNodeIndex(reduced_node_vec);
+
+    if (!circuit.diode_vec.empty()) {
+        const OperatingPoint& op = GetOperatingPoint();
+        if (!op.converged)
+            return false;
+        mat diode_g, diode_c;
+        GetDiodeSmallSignal(op, diode_g, diode_c);
+        G += diode_g;
+        C += diode_c;
+    }
+    return true;
+}
+
+/**
+ * @brief Poles are the roots of det(G + s * C). Zeros of the transfer function
+ * c^T * (G + s * C)^{-1} * u are the roots of the bordered pencil
+ * [G u; c^T 0] + s * [C 0; 0 0]. Small circuits get every root from QZ, large
+ * ones only the PZ_POLE_NUM roots nearest to the origin from Arnoldi.
+ *
+ * @param pz_analysis
+ */
+void Analyzer::DoPzAnalysis(const PzAnalysis pz_analysis) {
+    mat G, C;
+    QHash<NodeName, int> node_index;
+    if (!GetPencil(G, C, node_index)) {
+        cout << "Operating point failed, no poles and zeros" << endl;
+        return;
+    }
+    vec c, u;
+    if (!GetTransferStamps(pz_analysis, node_index, c, u))
+        return;
+
+    const int n = G.n_rows;
+    mat G_border(n + 1, n + 1, arma::fill::zeros);
+    mat C_border(n + 1, n + 1, arma::fill::zeros);
+    G_border(span(0, n - 1), span(0, n - 1)) = G;
+    G_border(span(0, n - 1), n) = u;
+    G_border(n, span(0, n - 1)) = c.t();
+    C_border(span(0, n - 1), span(0, n - 1)) = C;
+
+    bool dense = n <= PZ_DENSE_MAX;
+    if (dense) {
+        pz_result.pole_vec = DensePencilRoots(G, C);
+        pz_result.zero_vec = DensePencilRoots(G_border, C_border);
+    } else {
+        pz_result.pole_vec = ArnoldiPencilRoots(G, C, PZ_POLE_NUM);
+        pz_result.zero_vec = ArnoldiPencilRoots(G_border, C_border, PZ_POLE_NUM);
+    }
+
+    cout << "Pole-zero analysis (" << (dense ? "QZ" : "shift-invert Arnoldi")
+         << "), s in rad/s" << endl;
+    auto print_roots = [](const char* title, const cx_vec& root_vec) {
+        cout << title << ": " << root_vec.n_elem << endl;
+        if (root_vec.is_empty())
+            return;
+        cout << "  " << setw(14) << "real" << setw(14) << "imag" << endl;
+        for (cx_double s : root_vec)
+            cout << "  " << setw(14) << s.real() << setw(14) << s.imag() << endl;
+    };
+    print_roots("Poles", pz_result.pole_vec);
+    print_roots("Zeros", pz_result.zero_vec);
+}
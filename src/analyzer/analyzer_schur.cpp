@@ -0,0 +1,125 @@
+/**
+ * @file analyzer_schur.cpp
+ * @brief Elimination of the linear-only unknowns before the Newton iteration
+ * @date 2026-10-19
+ */
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::uvec;
+using arma::vec;
+
+// The Schur complement is used when at most 1/SCHUR_RATIO_MAX of the unknowns
+// are touched by nonlinear devices.
+constexpr int SCHUR_RATIO_MAX = 2;
+
+/**
+ * @brief Remap the indices of ExpTerms into the reduced system. `position`
+ * maps an index of the full system to the reduced one. The column of a RHS
+ * term is the RHS column and is kept.
+ */
+static std::vector<ExpTerm> RemapExpTerms(const std::vector<ExpTerm>& exp_term_vec,
+                                          const std::vector<int>& position,
+                                          const bool remap_col) {
+    auto remap = [&position](int index) { return index >= 0 ? position[index] : -1; };
+
+    std::vector<ExpTerm> remapped_vec = exp_term_vec;
+    for (ExpTerm& term : remapped_vec) {
+        term.row_index = remap(term.row_index);
+        if (remap_col)
+            term.col_index = remap(term.col_index);
+        term.node_1_index = remap(term.node_1_index);
+        term.node_2_index = remap(term.node_2_index);
+    }
+    return remapped_vec;
+}
+
+/**
+ * @brief Partition the unknowns into linear-only and touched by ExpTerms,
+ * factorize A_LL and build the Schur complement on the nonlinear part.
+ *
+ * @param system
+ * @param schur
+ * @return true: the partition is worthwhile and A_LL is nonsingular \
+ * @return false: keep solving the full system
+ */
+bool BuildSchurSystem(const NewtonSystem& system, SchurSystem& schur) {
+    const int size = system.mat.n_rows;
+
+    std::vector<bool> is_nonlinear(size, false);
+    auto mark = [&is_nonlinear](int index) {
+        if (index >= 0)
+            is_nonlinear[index] = true;
+    };
+    for (const ExpTerm& term : system.exp_analysis_vec) {
+        mark(term.row_index);
+        mark(term.col_index);
+        mark(term.node_1_index);
+        mark(term.node_2_index);
+    }
+    for (const ExpTerm& term : system.exp_rhs_vec) {
+        mark(term.row_index);
+        mark(term.node_1_index);
+        mark(term.node_2_index);
+    }
+
+    std::vector<arma::uword> linear_vec, nonlinear_vec;
+    std::vector<int> position(size, -1);
+    for (int i = 0; i < size; i++) {
+        if (is_nonlinear[i]) {
+            position[i] = nonlinear_vec.size();
+            nonlinear_vec.push_back(i);
+        } else
+            linear_vec.push_back(i);
+    }
+
+    if (linear_vec.empty() ||
+        static_cast<int>(nonlinear_vec.size()) * SCHUR_RATIO_MAX > size)
+        return false;
+
+    schur.linear_index = uvec(linear_vec);
+    schur.nonlinear_index = uvec(nonlinear_vec);
+    const uvec& L = schur.linear_index;
+    const uvec& N = schur.nonlinear_index;
+
+    if (!schur.linear_lu.Factorize(mat(system.mat.submat(L, L))))
+        return false;
+
+    schur.A_NL = system.mat.submat(N, L);
+    schur.Z = schur.linear_lu.Solve(mat(system.mat.submat(L, N)));
+
+    int voltage_num = 0;
+    for (arma::uword index : nonlinear_vec)
+        if (static_cast<int>(index) < system.voltage_num)
+            voltage_num++;
+
+    mat S = system.mat.submat(N, N) - schur.A_NL * schur.Z;
+    schur.reduced =
+        NewtonSystem(S, RemapExpTerms(system.exp_analysis_vec, position, true), mat(),
+                     RemapExpTerms(system.exp_rhs_vec, position, false), voltage_num);
+    return true;
+}
+
+/**
+ * @brief Condense a full RHS onto the nonlinear unknowns:
+ * b_N - A_NL * A_LL^{-1} * b_L
+ */
+void SetSchurRhs(SchurSystem& schur, const mat& rhs) {
+    schur.y = schur.linear_lu.Solve(mat(rhs.rows(schur.linear_index)));
+    schur.reduced.rhs = rhs.rows(schur.nonlinear_index) - schur.A_NL * schur.y;
+}
+
+vec GetSchurNonlinearPart(const SchurSystem& schur, const vec& x) {
+    return x.elem(schur.nonlinear_index);
+}
+
+/**
+ * @brief Back-substitution: x_L = A_LL^{-1} * (b_L - A_LN * x_N)
+ */
+vec RecoverSchurSolution(const SchurSystem& schur, const vec& x_nonlinear) {
+    vec x(schur.linear_index.n_elem + schur.nonlinear_index.n_elem);
+    x.elem(schur.nonlinear_index) = x_nonlinear;
+    x.elem(schur.linear_index) = schur.y - schur.Z * x_nonlinear;
+    return x;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file analyzer_sens.cpp
+ * @brief Adjoint DC analyses: sensitivity and transfer function
+ * @date 2026-10-19
+ */
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::setw;
+
+/**
+ * @brief Sensitivities of the DC outputs to every element value and diode
+ * parameter. With F(x, p) = 0 at the operating point,
+ * dy/dp = -lambda^T * dF/dp where J^T * lambda = dy/dx, so one transposed
+ * solve per output covers all parameters.
+ *
+ * @param sens_analysis
+ */
+void Analyzer::DoSensAnalysis(const SensAnalysis sens_analysis) {
+    const OperatingPoint& op = GetOperatingPoint();
+    if (!op.converged) {
+        cout << "Operating point failed, no sensitivities" << endl;
+        return;
+    }
+    const vec& x = op.result;
+    const int size = x.n_elem;
+
+    std::vector<NodeName> output_vec;
+    std::vector<arma::uword> output_index_vec;
+    for (NodeName node : sens_analysis.output_vec) {
+        int index = FindNode(op.node_vec, node);
+        if (index < 0)
+            continue;
+        output_vec.push_back(node);
+        output_index_vec.push_back(index);
+    }
+    if (output_vec.empty())
+        return;
+
+    mat adjoint_rhs(size, output_vec.size(), arma::fill::zeros);
+    for (std::size_t k = 0; k < output_index_vec.size(); k++)
+        adjoint_rhs(output_index_vec[k], k) = 1;
+    mat lambda = op.lu.SolveTransposed(adjoint_rhs);
+    run_stat.solve_num++;
+
+    auto index_of = [&op](NodeName node) { return FindNode(op.node_vec, node); };
+    auto voltage = [&x](int index) { return index >= 0 ? x(index) : 0; };
+    // e_1 - e_2 with gnd entries dropped
+    auto unit_vec = [size](int index_1, int index_2) {
+        vec u(size, arma::fill::zeros);
+        if (index_1 >= 0)
+            u(index_1) += 1;
+        if (index_2 >= 0)
+            u(index_2) -= 1;
+        return u;
+    };
+
+    // dF/dp of every parameter, F = (linear part) * x - rhs + diode currents
+    std::vector<std::string> param_vec;
+    std::vector<double> param_value_vec;
+    std::vector<vec> dF_vec;
+    auto add_param = [&](QString name, double value, vec dF) {
+        param_vec.push_back(name.toStdString());
+        param_value_vec.push_back(value);
+        dF_vec.push_back(dF);
+    };
+
+    for (Res res : circuit.res_vec) {
+        int i_1 = index_of(res.node_1), i_2 = index_of(res.node_2);
+        double v = voltage(i_1) - voltage(i_2);
+        add_param(res.name, res.value, -v / (res.value * res.value) * unit_vec(i_1, i_2));
+    }
+    // Capacitors and inductors do not enter the DC equations.
+    for (Cap cap : circuit.cap_vec)
+        add_param(cap.name, cap.value, vec(size, arma::fill::zeros));
+    for (Ind ind : circuit.ind_vec)
+        add_param(ind.name, ind.value, vec(size, arma::fill::zeros));
+    for (Vsrc vsrc : circuit.vsrc_vec)
+        add_param(vsrc.name, vsrc.value, -1 * unit_vec(index_of("i_" + vsrc.name), -1));
+    for (Isrc isrc : circuit.isrc_vec)
+        add_param(isrc.name, isrc.value,
+                  -1 * unit_vec(index_of(isrc.node_1), index_of(isrc.node_2)));
+    for (VCCS vccs : circuit.vccs_vec) {
+        double v_ctrl = voltage(index_of(vccs.ctrl_node_1)) -
+                        voltage(index_of(vccs.ctrl_node_2));
+        add_param(vccs.name, vccs.value,
+                  v_ctrl * unit_vec(index_of(vccs.node_1), index_of(vccs.node_2)));
+    }
+    for (VCVS vcvs : circuit.vcvs_vec) {
+        double v_ctrl = voltage(index_of(vcvs.ctrl_node_1)) -
+                        voltage(index_of(vcvs.ctrl_node_2));
+        add_param(vcvs.name, vcvs.value,
+                  -v_ctrl * unit_vec(index_of("i_" + vcvs.name), -1));
+    }
+
+    // I = is * (e^{v/vt} - 1) from node_1 to node_2
+    for (const Junction& junction : GetJunctions(op.system.exp_rhs_vec)) {
+        const Diode& diode = circuit.diode_vec[junction.diode_index];
+        double v = JunctionVoltage(junction, x);
+        double e = LimitedExp(v / junction.vt);
+        vec u = unit_vec(junction.node_1_index, junction.node_2_index);
+        add_param(diode.name + ":is", junction.i_sat, (e - 1) * u);
+        add_param(diode.name + ":vt", junction.vt,
+                  -junction.i_sat * e * v / (junction.vt * junction.vt) * u);
+    }
+
+    mat sens_mat(param_vec.size(), output_vec.size());
+    for (std::size_t p = 0; p < param_vec.size(); p++)
+        sens_mat.row(p) = -1 * dF_vec[p].t() * lambda;
+    sens_result = SensResult{param_vec, param_value_vec, output_vec, sens_mat};
+
+    cout << "DC sensitivities (" << output_vec.size() << " adjoint solves)" << endl;
+    cout << setw(12) << "param" << setw(14) << "value";
+    for (NodeName node : output_vec)
+        cout << setw(14) << "dv(" + node + ")";
+    cout << endl;
+    for (std::size_t p = 0; p < param_vec.size(); p++) {
+        cout << setw(12) << param_vec[p] << setw(14) << param_value_vec[p];
+        for (std::size_t k = 0; k < output_vec.size(); k++)
+            cout << setw(14) << sens_mat(p, k);
+        cout << endl;
+    }
+}
+
+/**
+ * @brief Small-signal DC gain, input and output resistance at the operating
+ * point. With c selecting the output and u the input source stamp, one
+ * transposed solve J^T * lambda = c and one solve J * z = u give
+ * gain = lambda^T * u, input resistance from z and output resistance from
+ * lambda^T * c.
+ *
+ * @param tf_analysis
+ */
+void Analyzer::DoTfAnalysis(const TfAnalysis tf_analysis) {
+    const OperatingPoint& op = GetOperatingPoint();
+    if (!op.converged) {
+        cout << "Operating point failed, no transfer function" << endl;
+        return;
+    }
+    vec c, u;
+    if (!GetTransferStamps(tf_analysis, op.node_index, c, u))
+        return;
+    bool vsrc_input = op.node_index.contains("i_" + tf_analysis.src_name);
+    QString out_name = tf_analysis.out_i_v == V ? "v(" + tf_analysis.out_node_1 + "," +
+                                                      tf_analysis.out_node_2 + ")"
+                                                : "i(" + tf_analysis.out_node_1 + ")";
+
+    vec lambda = op.lu.SolveTransposed(c);
+    vec z = op.lu.Solve(u);
+    run_stat.solve_num += 2;
+
+    tf_result.gain = arma::dot(lambda, u);
+    // A voltage source sees -dV/di of its own branch current, a current source
+    // sees d(v_1 - v_2)/dI.
+    double input_response = arma::dot(u, z);
+    tf_result.input_resistance = vsrc_input ? -1 / input_response : input_response;
+    tf_result.output_resistance =
+        tf_analysis.out_i_v == V ? arma::dot(lambda, c) : arma::datum::nan;
+
+    cout << "Transfer function " << out_name << " / " << tf_analysis.src_name << " = "
+         << tf_result.gain << endl;
+    cout << "Input resistance at " << tf_analysis.src_name << " = "
+         << tf_result.input_resistance << endl;
+    if (tf_analysis.out_i_v == V)
+        cout << "Output resistance at " << out_name << " = "
+             << tf_result.output_resistance << endl;
+}
+
+/**
+ * @brief The output selector c (y = c^T * x) and the input source stamp u
+ * (b += u * value) of a .tf or .pz command.
+ *
+ * @param tf_analysis
+ * @param node_index of the reduced system
+ * @param c
+ * @param u
+ * @return true: the output and the input source are found
+ */
+bool Analyzer::GetTransferStamps(const TfAnalysis tf_analysis,
+                                 const QHash<NodeName, int>& node_index, vec& c, vec& u) {
+    const int size = node_index.size();
+    auto index_of = [&node_index](NodeName node) { return node_index.value(node, -1); };
+    auto unit_vec = [size](int index_1, int index_2) {
+        vec e(size, arma::fill::zeros);
+        if (index_1 >= 0)
+            e(index_1) += 1;
+        if (index_2 >= 0)
+            e(index_2) -= 1;
+        return e;
+    };
+
+    if (tf_analysis.out_i_v == V)
+        c = unit_vec(index_of(tf_analysis.out_node_1), index_of(tf_analysis.out_node_2));
+    else
+        c = unit_vec(index_of("i_" + tf_analysis.out_node_1), -1);
+
+    u.reset();
+    if (node_index.contains("i_" + tf_analysis.src_name))
+        u = unit_vec(index_of("i_" + tf_analysis.src_name), -1);
+    for (Isrc isrc : circuit.isrc_vec)
+        if (isrc.name == tf_analysis.src_name)
+            u = unit_vec(index_of(isrc.node_1), index_of(isrc.node_2));
+
+    if (u.is_empty()) {
+        cout << "Not found: " << tf_analysis.src_name << endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file analyzer_source.cpp
+ * @brief Transient source table evaluated once per step for all sources
+ * @date 2026-10-19
+ */
+
+#include "analyzer.h"
+
+using arma::uvec;
+using arma::vec;
+
+/**
+ * @brief Look up every source row once. A current source runs from node_1
+ * to node_2 and adds -I at node_1 and +I at node_2, as in the stepper.
+ *
+ * @param circuit
+ * @param node_vec the unknowns of the RHS, gnd removed
+ */
+void SourceTable::Build(const Circuit& circuit, const std::vector<NodeName>& node_vec) {
+    QHash<NodeName, int> node_index = GetNodeIndex(node_vec);
+    constant_rhs = vec(node_vec.size(), arma::fill::zeros);
+
+    std::vector<arma::uword> pulse_row_vec, sin_row_vec;
+    std::vector<Pulse> pulse_vec;
+    std::vector<Sin> sin_vec;
+    for (Vsrc vsrc : circuit.vsrc_vec) {
+        int index = node_index.value("i_" + vsrc.name);
+        if (vsrc.pulse.chosen) {
+            pulse_row_vec.push_back(index);
+            pulse_vec.push_back(vsrc.pulse);
+        } else if (vsrc.sin.chosen) {
+            sin_row_vec.push_back(index);
+            sin_vec.push_back(vsrc.sin);
+        } else
+            constant_rhs(index) += vsrc.value;
+    }
+    for (Isrc isrc : circuit.isrc_vec) {
+        int index_1 = node_index.value(isrc.node_1, -1);
+        int index_2 = node_index.value(isrc.node_2, -1);
+        if (index_1 >= 0)
+            constant_rhs(index_1) -= isrc.tran_const_value;
+        if (index_2 >= 0)
+            constant_rhs(index_2) += isrc.tran_const_value;
+    }
+
+    auto column = [](const auto& src_vec, auto field) {
+        vec c(src_vec.size());
+        for (std::size_t i = 0; i < src_vec.size(); i++)
+            c(i) = src_vec[i].*field;
+        return c;
+    };
+    pulse_index = uvec(pulse_row_vec);
+    v1 = column(pulse_vec, &Pulse::v1);
+    v2 = column(pulse_vec, &Pulse::v2);
+    td = column(pulse_vec, &Pulse::td);
+    tr = column(pulse_vec, &Pulse::tr);
+    pw = column(pulse_vec, &Pulse::pw);
+    tf = column(pulse_vec, &Pulse::tf);
+    per = column(pulse_vec, &Pulse::per);
+    k_r = (v2 - v1) / tr;
+    k_f = (v1 - v2) / tf;
+
+    sin_index = uvec(sin_row_vec);
+    v0 = column(sin_vec, &Sin::v0);
+    va = column(sin_vec, &Sin::va);
+    freq = column(sin_vec, &Sin::freq);
+    sin_td = column(sin_vec, &Sin::td);
+    theta = column(sin_vec, &Sin::theta);
+}
+
+/**
+ * @brief Add the sources at time t to rhs. Same waveforms as GetPulseValue
+ * and GetSinValue.
+ *
+ * @param t
+ * @param rhs
+ */
+void SourceTable::Apply(const double t, vec& rhs) const {
+    rhs += constant_rhs;
+
+    if (!pulse_index.is_empty()) {
+        const vec tau = t - td;
+        const vec phase = tau - arma::floor(tau / per) % per;
+        // Later pieces first, each earlier one overwrites its part.
+        vec value = v1;
+        uvec piece = arma::find(phase < tr + pw + tf);
+        value(piece) = v2(piece) + k_f(piece) % (phase(piece) - tr(piece) - pw(piece));
+        piece = arma::find(phase < tr + pw);
+        value(piece) = v2(piece);
+        piece = arma::find(phase < tr);
+        value(piece) = v1(piece) + k_r(piece) % phase(piece);
+        piece = arma::find(tau <= 0);
+        value(piece) = v1(piece);
+        rhs(pulse_index) += value;
+    }
+
+    if (!sin_index.is_empty()) {
+        const vec tau = t - sin_td;
+        vec value =
+            v0 + va % arma::exp(-1 * tau % theta) % arma::sin(2 * M_PI * freq % tau);
+        uvec before = arma::find(tau <= 0);
+        value(before) = v0(before);
+        rhs(sin_index) += value;
+    }
+}
@@ -8,17 +8,23 @@
 #ifndef ANALYZER_TYPE_H
 #define ANALYZER_TYPE_H
 
+#include <QHash>
 #include <armadillo>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <queue>
 #include <vector>
 
 #include "../parser/parser.h"
 
+const int MAX_NEWTON_ITER = 100;
+
 struct ExpCoeff {
     std::complex<double> exp;
     double constant;
 
-    ExpCoeff() {}
+    ExpCoeff() : exp(0, 0), constant(0) {}
     ExpCoeff(double a, double b) : exp(a, b), constant(0) {}
     ExpCoeff(double a, double b, double c) : exp(a, b), constant(c) {}
 };
@@ -32,6 +38,8 @@ struct ExpTerm {
     int node_2_index;
     ExpCoeff zero_order;   // a*e^{bx}+c -> (a, b, c)
     ExpCoeff first_order;  // (a*e^{bx}+c)*x -> (a, b, c)
+    // The diode in circuit.diode_vec that stamped the term
+    int device_index = -1;
 
     ExpTerm() {}
 
@@ -93,6 +101,231 @@ struct AnalysisMatrix {
           exp_rhs_vec(exp_rhs_vec) {}
 };
 
+// A diode junction x = V(node_1) - V(node_2) with I = i_sat * (e^{x/vt} - 1),
+// used for pnjlim-style voltage limiting.
+struct Junction {
+    int node_1_index;
+    int node_2_index;
+    double vt;
+    double i_sat;
+    double v_crit;
+    int diode_index;  // In circuit.diode_vec
+
+    Junction() {}
+    Junction(int node_1_index, int node_2_index, double vt, double i_sat,
+             int diode_index)
+        : node_1_index(node_1_index),
+          node_2_index(node_2_index),
+          vt(vt),
+          i_sat(i_sat),
+          v_crit(vt * log(vt / (M_SQRT2 * i_sat))),
+          diode_index(diode_index) {}
+};
+
+long NextMatVersion();
+
+// A reduced (gnd removed) MNA system whose nonlinear part is given by ExpTerms:
+// AddExpTerm(exp_analysis_vec, x, mat) * x = AddExpTerm(exp_rhs_vec, x, rhs)
+struct NewtonSystem {
+    arma::mat mat;
+    std::vector<ExpTerm> exp_analysis_vec;
+    arma::mat rhs;
+    std::vector<ExpTerm> exp_rhs_vec;
+    int voltage_num;  // The first `voltage_num` unknowns are node voltages
+    // Same version, same `mat`. Copies keep it, MatChanged() after every
+    // change of `mat` gives a new one.
+    long mat_version = NextMatVersion();
+
+    void MatChanged() { mat_version = NextMatVersion(); }
+
+    NewtonSystem() {}
+    NewtonSystem(arma::mat mat, std::vector<ExpTerm> exp_analysis_vec, arma::mat rhs,
+                 std::vector<ExpTerm> exp_rhs_vec, int voltage_num)
+        : mat(mat),
+          exp_analysis_vec(exp_analysis_vec),
+          rhs(rhs),
+          exp_rhs_vec(exp_rhs_vec),
+          voltage_num(voltage_num) {}
+};
+
+struct ConvergenceCriteria {
+    double vntol;
+    double abstol;
+    double reltol;
+
+    ConvergenceCriteria() : ConvergenceCriteria(SimOptions()) {}
+    ConvergenceCriteria(const SimOptions& options)
+        : vntol(options.vntol), abstol(options.abstol), reltol(options.reltol) {}
+};
+
+// Norms of one Newton iteration, kept for diagnostics
+struct IterationNorm {
+    double update_norm;         // inf-norm of the full Newton update
+    double residual_norm;       // inf-norm of the KCL residual after the step
+    double damping;             // Fraction of the Newton update taken
+    double refactor_fraction;   // Fraction of the LU columns recomputed
+
+    IterationNorm(double update_norm, double residual_norm, double damping,
+                  double refactor_fraction)
+        : update_norm(update_norm),
+          residual_norm(residual_norm),
+          damping(damping),
+          refactor_fraction(refactor_fraction) {}
+};
+
+typedef std::vector<IterationNorm> ConvergenceHistory;
+
+// LU factorization A(row_perm, col_perm) = L * U kept for repeated solves.
+// The pivot sequence can be reused to redo only the trailing part.
+struct LuFactor {
+    arma::mat L;
+    arma::mat U;
+    arma::uvec row_perm;
+    arma::uvec col_perm;
+    arma::uvec row_pos;  // Inverse of row_perm
+    arma::uvec col_pos;  // Inverse of col_perm
+    bool valid = false;
+    // NewtonSystem::mat_version of the linear part at the last full Jacobian
+    // factorization, -1 for none. Refactor is only exact while it is the same.
+    long linear_version = -1;
+
+    bool Factorize(const arma::mat& A);
+    bool Factorize(const arma::mat& A, const std::vector<bool>& late);
+    bool Refactor(const arma::mat& A, const int first_step);
+    int FirstStep(const std::vector<ExpTerm>& exp_term_vec) const;
+    arma::mat Solve(const arma::mat& b) const;
+    arma::mat SolveTransposed(const arma::mat& b) const;
+};
+
+// A NewtonSystem with its linear-only unknowns eliminated once. Newton runs on
+// `reduced`, the Schur complement S = A_NN - A_NL * A_LL^{-1} * A_LN on the
+// unknowns touched by ExpTerms, and the rest is recovered by back-substitution.
+struct SchurSystem {
+    arma::uvec linear_index;
+    arma::uvec nonlinear_index;
+    LuFactor linear_lu;  // A_LL
+    arma::mat A_NL;
+    arma::mat Z;         // A_LL^{-1} * A_LN
+    arma::vec y;         // A_LL^{-1} * b_L of the current RHS
+    NewtonSystem reduced;
+};
+
+// The DC operating point together with the LU factorization of the Jacobian
+// there, shared by the analyses that linearize around it.
+struct OperatingPoint {
+    bool converged = false;
+    arma::vec result;
+    std::vector<NodeName> node_vec;  // Reduced, gnd removed
+    QHash<NodeName, int> node_index;  // Of node_vec, gnd is absent
+    NewtonSystem system;
+    LuFactor lu;
+};
+
+// A linear system whose matrix has been changed by low-rank updates
+// A + U * V^T since its last factorization. Solves use the
+// Sherman-Morrison-Woodbury formula on top of the factorization of A.
+struct LowRankSolver {
+    arma::mat base;  // A
+    LuFactor lu;     // of A
+    arma::mat U;
+    arma::mat V;
+    arma::mat Z;  // A^{-1} * U
+    arma::mat K;  // I + V^T * A^{-1} * U
+    int refactor_num = 0;
+
+    bool Factorize(const arma::mat& A);
+    bool Update(const arma::vec& u, const arma::vec& v);
+    arma::vec Solve(const arma::vec& b) const;
+    int Rank() const { return U.n_cols; }
+};
+
+enum FaultType { OPEN, SHORT, STUCK };
+const std::string FaultType_lookup[] = {"open", "short", "stuck-at-0"};
+
+// One single-fault variant of the nominal DC system, expressed as a rank-1
+// change (A + u * v^T) * x = b + delta_rhs. Either part may be empty.
+struct Fault {
+    DeviceName name;
+    FaultType type;
+    arma::vec u;
+    arma::vec v;
+    arma::vec delta_rhs;
+
+    Fault() {}
+    Fault(DeviceName name, FaultType type) : name(name), type(type) {}
+};
+
+struct FaultResult {
+    bool solved = false;  // false: the fault makes the circuit singular
+    arma::vec result;
+    std::vector<bool> detected_vec;  // One flag per observed output
+};
+
+struct RunStatistics {
+    int newton_iter_num = 0;
+    int factorization_num = 0;
+    int partial_refactor_num = 0;
+    double recomputed_fraction_sum = 0;  // Over the partial refactorizations
+    int solve_num = 0;
+
+    void Add(const RunStatistics& other) {
+        newton_iter_num += other.newton_iter_num;
+        factorization_num += other.factorization_num;
+        partial_refactor_num += other.partial_refactor_num;
+        recomputed_fraction_sum += other.recomputed_fraction_sum;
+        solve_num += other.solve_num;
+    }
+};
+
+struct NewtonSetting {
+    int max_iter;
+    bool pseudo_tran;  // Start from pseudo-transient instead of plain Newton
+    bool chord;        // Reuse the LU factorization while convergence is fast
+    ConvergenceCriteria criteria;
+    ConvergenceHistory* history;  // Appended to every iteration if not null
+    LuFactor* lu;         // Factorization shared between calls if not null
+    RunStatistics* stat;  // Counters are added to if not null
+
+    NewtonSetting()
+        : max_iter(MAX_NEWTON_ITER),
+          pseudo_tran(false),
+          chord(false),
+          history(nullptr),
+          lu(nullptr),
+          stat(nullptr) {}
+    NewtonSetting(const SimOptions& options)
+        : max_iter(options.itl1),
+          pseudo_tran(options.pseudo_tran),
+          chord(options.chord),
+          criteria(options),
+          history(nullptr),
+          lu(nullptr),
+          stat(nullptr) {}
+};
+
+struct PseudoTranStat {
+    int step_num = 0;
+    double residual = 0;
+    double time = 0;  // seconds
+};
+
+// Which convergence aids were tried for one operating point and how many
+// Newton iterations each of them took.
+struct ConvergenceReport {
+    std::vector<std::string> strategy_vec;
+    std::vector<int> iteration_vec;
+    std::string converged_strategy;
+    bool converged = false;
+    bool pseudo_tran_ran = false;
+    PseudoTranStat pseudo_tran_stat;
+    ConvergenceHistory history;  // Of the first strategy
+
+    void Add(const std::string strategy, const int iteration) {
+        strategy_vec.push_back(strategy);
+        iteration_vec.push_back(iteration);
+    }
+};
+
 struct TranResult {
     arma::mat tran_result_mat;
     std::vector<double> time_point_vec;
@@ -117,12 +350,132 @@ struct TranAnalysisMat {
           exp_rhs_vec(exp_rhs_vec) {}
 };
 
+// The transient sources compiled once for a given unknown layout. DC
+// voltage sources and current sources go into a constant RHS, Pulse and Sin
+// parameters are kept as columns so that all sources of a kind are evaluated
+// in one vector expression per step.
+struct SourceTable {
+    arma::vec constant_rhs;
+    arma::uvec pulse_index;  // Branch rows of the pulse sources
+    arma::vec v1, v2, td, tr, pw, tf, per, k_r, k_f;
+    arma::uvec sin_index;
+    arma::vec v0, va, freq, sin_td, theta;
+
+    void Build(const Circuit& circuit, const std::vector<NodeName>& node_vec);
+    void Apply(const double t, arma::vec& rhs) const;
+};
+
+// The Backward Euler system of a transient run with its solver state, so that
+// DoTranAnalysis and the analyses built on it can take single steps.
+struct TranStepper {
+    double h;
+    arma::mat MNA;      // Reduced, gnd removed
+    arma::mat RHS_gen;  // RHS of a step is RHS_gen * x_prev plus the sources
+    std::vector<NodeName> node_vec;
+    SourceTable source_table;
+    NewtonSystem newton_system;
+    NewtonSetting newton_setting;
+    LuFactor lu;  // Shared by all steps, given to NewtonSolve
+    bool use_schur = false;
+    SchurSystem schur;
+};
+
+// The corners of one source waveform, repeated every `per` from `td` on
+struct SourceCorners {
+    std::vector<double> offset_vec;  // Within one period, ascending
+    double td;
+    double per;  // 0: the corners happen once
+    int period = 0;
+    int corner = 0;
+
+    double Time() const { return td + period * per + offset_vec[corner]; }
+};
+
+// Upcoming source breakpoints in time order. Each source has only its next
+// corner queued, the following one is generated when it is popped, so a
+// periodic source costs O(1) memory however long the run.
+struct BreakpointQueue {
+    std::vector<SourceCorners> source_vec;
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>,
+                        std::greater<std::pair<double, int>>>
+        queue;
+
+    void Init(const std::vector<Vsrc>& vsrc_vec, const double t_start);
+    double NextAfter(const double t, const double tol = 0);
+};
+
+// One block of a multirate transient. It steps `ratio` global steps at a
+// time, from grid index n_start to n_end, and is frozen while its RHS stops
+// changing.
+struct TranPartition {
+    arma::uvec index;  // Unknowns of the full system, ascending
+    arma::uvec other;  // The rest of the unknowns
+    bool nonlinear = false;
+    bool driven = false;  // Has a Pulse or Sin source
+    int ratio = 1;
+    int n_start = 0;
+    int n_end = 0;
+    arma::vec x_start;
+    arma::vec x_end;
+    arma::vec last_rhs;
+    int last_ratio = 0;
+    arma::vec other_guess;  // Values of `other` the last step was solved with
+    NewtonSystem system;  // Diodes of the block, linear part set per step
+    int system_steps = 0;  // The step length system.mat was set for
+    std::map<int, LuFactor> lu_map;  // By step length in global steps
+    int step_num = 0;
+    int latent_num = 0;
+    int reject_num = 0;
+    int max_ratio = 1;
+};
+
 struct DcResult {
     std::vector<arma::vec> dc_result_vec;
     std::vector<double> dc_value_vec;
     std::vector<NodeName> node_vec;
 };
 
+// d(output) / d(parameter), one column per output
+struct SensResult {
+    std::vector<std::string> param_vec;
+    std::vector<double> param_value_vec;
+    std::vector<NodeName> output_vec;
+    arma::mat sens_mat;
+};
+
+struct TfResult {
+    double gain;
+    double input_resistance;
+    double output_resistance;  // NaN for a current output
+};
+
+struct PzResult {
+    arma::cx_vec pole_vec;  // rad/s
+    arma::cx_vec zero_vec;
+};
+
+// A noise current source between two nodes of the reduced system
+struct NoiseSource {
+    std::string name;
+    int node_1_index;
+    int node_2_index;
+    double psd;  // A^2/Hz
+};
+
+struct NoiseResult {
+    std::vector<double> freq_vec;
+    std::vector<std::string> source_vec;
+    arma::mat contribution_mat;  // Output PSD of each source, one row per frequency
+    arma::vec output_psd;
+    arma::vec input_psd;  // Referred to the input source
+};
+
+struct HbResult {
+    double f0;
+    arma::mat amplitude_mat;  // |X_0| and 2 * |X_k|, one row per harmonic
+    std::vector<NodeName> node_vec;
+};
+
 struct AcResult {
     std::vector<arma::cx_vec> ac_result_vec;
     std::vector<double> freq_vec;
@@ -13,39 +13,113 @@ using std::endl;
 using std::setw;
 using std::vector;
 
-Analyzer::Analyzer(Parser parser) {
+// exp() is continued linearly above this argument so that a wild Newton
+// guess cannot overflow to inf.
+constexpr double EXP_ARG_MAX = 80;
+
+/**
+ * @brief Run the analysis of the netlist. The .print variables of DC, AC and
+ * TRAN are plotted, or written to cout when plot is false.
+ *
+ * @param parser
+ * @param plot
+ */
+Analyzer::Analyzer(Parser parser, const bool plot) {
     circuit = parser.GetCircuit();
+    options = parser.GetOptions();
+    ic_vec = parser.GetInitialConditions();
+    nodeset_vec = parser.GetNodesets();
 
     auto analysis_type = parser.GetAnalysisType();
     auto dc_analysis = parser.GetDcAnalysis();
     auto ac_analysis = parser.GetAcAnalysis();
     auto tran_analysis = parser.GetTranAnalysis();
+    auto fault_analysis = parser.GetFaultAnalysis();
+    auto sens_analysis = parser.GetSensAnalysis();
+    auto tf_analysis = parser.GetTfAnalysis();
+    auto pz_analysis = parser.GetPzAnalysis();
+    auto noise_analysis = parser.GetNoiseAnalysis();
+    auto hb_analysis = parser.GetHbAnalysis();
+    auto pss_analysis = parser.GetPssAnalysis();
     auto print_variable_vec = parser.GetPrintVariables();
+    auto alter_vec = parser.GetAlters();
 
     switch (analysis_type) {
+        case OP: {
+            cout << "Running OP analysis" << endl;
+            DoOpAnalysis(print_variable_vec);
+            PrintRunStatistics(run_stat);
+            break;
+        }
         case DC: {
             cout << "Running DC analysis" << endl;
             DoDcAnalysis(dc_analysis);
+            PrintRunStatistics(run_stat);
             if (!print_variable_vec.empty())
-                DcPlot(dc_result, print_variable_vec);
+                DcPlot(dc_result, print_variable_vec, !plot);
             break;
         }
         case AC: {
             cout << "Running AC analysis" << endl;
             DoAcAnalysis(ac_analysis);
             if (!print_variable_vec.empty())
-                AcPlot(ac_result, print_variable_vec);
+                AcPlot(ac_result, print_variable_vec, !plot);
             break;
         }
         case TRAN: {
             cout << "Running TRAN analysis" << endl;
             DoTranAnalysis(tran_analysis);
+            PrintRunStatistics(run_stat);
             if (!print_variable_vec.empty())
-                TranPlot(tran_result, print_variable_vec);
+                TranPlot(tran_result, print_variable_vec, !plot);
+            break;
+        }
+        case FAULT: {
+            cout << "Running FAULT analysis" << endl;
+            DoFaultAnalysis(fault_analysis, print_variable_vec);
+            break;
+        }
+        case SENS: {
+            cout << "Running SENS analysis" << endl;
+            DoSensAnalysis(sens_analysis);
+            PrintRunStatistics(run_stat);
+            break;
+        }
+        case TF: {
+            cout << "Running TF analysis" << endl;
+            DoTfAnalysis(tf_analysis);
+            break;
+        }
+        case PZ: {
+            cout << "Running PZ analysis" << endl;
+            DoPzAnalysis(pz_analysis);
+            break;
+        }
+        case NOISE: {
+            cout << "Running NOISE analysis" << endl;
+            DoNoiseAnalysis(noise_analysis);
+            break;
+        }
+        case DISTO: {
+            cout << "Running HB analysis" << endl;
+            DoHbAnalysis(hb_analysis, print_variable_vec);
+            break;
+        }
+        case PSS: {
+            cout << "Running PSS analysis" << endl;
+            DoPssAnalysis(pss_analysis);
+            PrintRunStatistics(run_stat);
+            if (!print_variable_vec.empty())
+                TranPlot(tran_result, print_variable_vec, !plot);
             break;
         }
         default: break;
     }
+
+    if (!alter_vec.empty()) {
+        cout << "Running ALTER" << endl;
+        DoAlterAnalysis(alter_vec);
+    }
 }
 
 void Analyzer::PrintMatrix(cx_mat mat, vector<NodeName> nodes) {
@@ -102,6 +176,24 @@ void Analyzer::PrintRHS(cx_mat rhs, vector<NodeName> nodes) {
     }
 }
 
+DiodeModel FindDiodeModel(const Circuit& circuit, const ModelName model) {
+    for (DiodeModel d_model : circuit.diode_model_vec)
+        if (d_model.model == model)
+            return d_model;
+    return diode_model_lut.front();
+}
+
+/**
+ * @brief Name to index map of `node_vec`, for lookups without a linear scan.
+ */
+QHash<NodeName, int> GetNodeIndex(const vector<NodeName>& node_vec) {
+    QHash<NodeName, int> node_index;
+    node_index.reserve(node_vec.size());
+    for (std::size_t i = 0; i < node_vec.size(); i++)
+        node_index.insert(node_vec[i], i);
+    return node_index;
+}
+
 int FindNode(vector<NodeName> node_vec, NodeName name) {
     for (std::size_t i = 0; i < node_vec.size(); i++) {
         if (node_vec[i] == name) {
@@ -141,8 +233,8 @@ arma::mat AddExpTerm(const std::vector<ExpTerm> exp_term_vec, const arma::vec re
         if (row_index >= 0 && col_index >= 0) {
             mat(row_index, col_index) +=
                 zero_order.constant +
-                zero_order.exp.real() * exp(zero_order.exp.imag() * value) +
-                (first_order.exp.real() * exp(first_order.exp.imag() * value) +
+                zero_order.exp.real() * LimitedExp(zero_order.exp.imag() * value) +
+                (first_order.exp.real() * LimitedExp(first_order.exp.imag() * value) +
                  first_order.constant) *
                     value;
         }
@@ -150,16 +242,54 @@ arma::mat AddExpTerm(const std::vector<ExpTerm> exp_term_vec, const arma::vec re
     return mat;
 }
 
-double VecDifference(arma::vec vec_old, arma::vec vec_new) {
-    arma::vec diff = vec_old - vec_new;
-    int size = vec_old.size();
+/**
+ * @brief ExpTerms of the diodes, I = is * (e^{v/vt} - 1) from node_1 to node_2
+ * with the is and vt = n * THERMAL_VOLTAGE of their model. The Jacobian gets
+ * g = is / vt * e^{v/vt}, the RHS -I + g * v.
+ *
+ * @param circuit
+ * @param exp_analysis_vec the Jacobian terms are added to it
+ * @param exp_rhs_vec the RHS terms are added to it
+ */
+void AddDiodeStamps(const Circuit& circuit, vector<ExpTerm>& exp_analysis_vec,
+                    vector<ExpTerm>& exp_rhs_vec) {
+    for (std::size_t k = 0; k < circuit.diode_vec.size(); k++) {
+        const Diode& diode = circuit.diode_vec[k];
+        DiodeModel model = FindDiodeModel(circuit, diode.model);
+        const double i_sat = model.i_sat;
+        const double b = 1 / (model.n * THERMAL_VOLTAGE);
+        const double g = i_sat * b;
+        int node_1_index = FindNode(circuit.node_vec, diode.node_1);
+        int node_2_index = FindNode(circuit.node_vec, diode.node_2);
+        const std::size_t term_begin = exp_analysis_vec.size();
+        const std::size_t rhs_begin = exp_rhs_vec.size();
+        exp_analysis_vec.push_back(ExpTerm(node_1_index, node_1_index, node_1_index,
+                                           node_2_index, ExpCoeff(g, b)));
+        exp_analysis_vec.push_back(ExpTerm(node_1_index, node_2_index, node_1_index,
+                                           node_2_index, ExpCoeff(-g, b)));
+        exp_analysis_vec.push_back(ExpTerm(node_2_index, node_1_index, node_1_index,
+                                           node_2_index, ExpCoeff(-g, b)));
+        exp_analysis_vec.push_back(ExpTerm(node_2_index, node_2_index, node_1_index,
+                                           node_2_index, ExpCoeff(g, b)));
+
+        exp_rhs_vec.push_back(ExpTerm(node_1_index, node_1_index, node_2_index,
+                                      ExpCoeff(-i_sat, b, i_sat), ExpCoeff(g, b)));
+        exp_rhs_vec.push_back(ExpTerm(node_2_index, node_1_index, node_2_index,
+                                      ExpCoeff(i_sat, b, -i_sat), ExpCoeff(-g, b)));
 
-    for (int i = 0; i < size; i++) {
-        double delta = fabs(diff(i));
-        double epsilon = std::min(EPSILON_ABS, EPSILON_REL * fabs(vec_old(i)));
-        if (delta > epsilon)
-            return false;
+        // Tag the terms with their diode
+        for (std::size_t i = term_begin; i < exp_analysis_vec.size(); i++)
+            exp_analysis_vec[i].device_index = static_cast<int>(k);
+        for (std::size_t i = rhs_begin; i < exp_rhs_vec.size(); i++)
+            exp_rhs_vec[i].device_index = static_cast<int>(k);
     }
+}
 
-    return true;
-}
\ No newline at end of file
+/**
+ * @brief exp(x), continued linearly (value and slope matched) above EXP_ARG_MAX.
+ */
+double LimitedExp(const double x) {
+    if (x <= EXP_ARG_MAX)
+        return exp(x);
+    return exp(EXP_ARG_MAX) * (1 + x - EXP_ARG_MAX);
+}
@@ -0,0 +1,193 @@
+/**
+ * @file analyzer_wr.cpp
+ * @brief Waveform relaxation transient across partitions on threads
+ * @date 2026-10-19
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include "analyzer.h"
+
+using arma::mat;
+using arma::span;
+using arma::uvec;
+using arma::vec;
+using std::cout;
+using std::endl;
+using std::vector;
+
+// Waveform relaxation sweeps windows of this many steps, at most WR_MAX_ITER
+// times each.
+constexpr int WR_WINDOW_STEPS = 200;
+constexpr int WR_MAX_ITER = 50;
+
+/**
+ * @brief Backward Euler transient by Gauss-Jacobi waveform relaxation. The
+ * blocks of PartitionUnknowns are simulated over a window of WR_WINDOW_STEPS
+ * steps each on its own thread, seeing the other blocks through their
+ * waveforms from the previous sweep. Sweeps repeat until no waveform moves by
+ * more than the Newton tolerance, then the next window starts from the end of
+ * this one.
+ *
+ * @param tran_analysis
+ * @return false: the circuit is a single block, nothing was simulated
+ */
+bool Analyzer::DoWrTranAnalysis(const TranAnalysis tran_analysis) {
+    const double t_start = tran_analysis.t_start;
+    const double h = tran_analysis.t_step;
+    const int scan_num = (tran_analysis.t_stop - t_start) / h;
+
+    TranAnalysisMat be = BackEuler(circuit, h);
+    const int total_node_num = be.node_vec.size();
+    span reduced(1, total_node_num - 1);
+    const mat MNA = be.MNA(reduced, reduced);
+    const mat RHS_gen = be.RHS_gen(reduced, reduced);
+
+    vector<NodeName> node_vec = be.node_vec;
+    node_vec.erase(node_vec.begin());
+    const int size = node_vec.size();
+    const int voltage_num = circuit.node_vec.size() - 1;
+    const arma::uword voltage_end = voltage_num;
+
+    SourceTable source_table;
+    source_table.Build(circuit, node_vec);
+
+    vector<uvec> block_vec =
+        PartitionUnknowns(MNA, be.exp_analysis_vec, MULTIRATE_COUPLING);
+    if (block_vec.size() < 2)
+        return false;
+    vector<TranPartition> part_vec(block_vec.size());
+    vector<mat> coupling_vec(block_vec.size());  // MNA(index, other)
+    for (std::size_t k = 0; k < block_vec.size(); k++) {
+        TranPartition& part = part_vec[k];
+        part.index = block_vec[k];
+        vector<bool> inside(size, false);
+        for (arma::uword i : part.index)
+            inside[i] = true;
+        vector<arma::uword> other_vec;
+        for (int i = 0; i < size; i++)
+            if (!inside[i])
+                other_vec.push_back(i);
+        part.other = uvec(other_vec);
+
+        vector<ExpTerm> exp_analysis_vec =
+            RestrictExpTerms(be.exp_analysis_vec, part.index, false);
+        vector<ExpTerm> exp_rhs_vec =
+            RestrictExpTerms(be.exp_rhs_vec, part.index, true);
+        part.system = NewtonSystem(MNA(part.index, part.index), exp_analysis_vec, mat(),
+                                   exp_rhs_vec, arma::accu(part.index < voltage_end));
+        part.nonlinear = !part.system.exp_analysis_vec.empty();
+        if (!part.nonlinear) {
+            run_stat.factorization_num++;
+            if (!part.lu_map[1].Factorize(part.system.mat)) {
+                cout << "Singular MNA matrix in partition " << k << ", no transient"
+                     << endl;
+                return true;
+            }
+        }
+        coupling_vec[k] = MNA(part.index, part.other);
+    }
+    const int part_num = part_vec.size();
+
+    int thread_num = std::max(1u, std::thread::hardware_concurrency());
+    thread_num = std::min(thread_num, part_num);
+
+    vector<RunStatistics> stat_vec(thread_num);
+
+    const ConvergenceCriteria criteria(options);
+    mat tran_result_mat(size, scan_num + 1, arma::fill::zeros);
+    tran_result_mat.col(0) = GetTranInitialState(tran_analysis, node_vec);
+    vector<double> time_point_vec = {t_start};
+    for (int n = 1; n <= scan_num; n++)
+        time_point_vec.push_back(t_start + n * h);
+
+    int window_num = 0, sweep_sum = 0, max_sweep = 0;
+    for (int n_0 = 0; n_0 < scan_num; n_0 += WR_WINDOW_STEPS) {
+        const int n_1 = std::min(n_0 + WR_WINDOW_STEPS, scan_num);
+        const int length = n_1 - n_0;
+        window_num++;
+
+        vector<vec> b_vec(length, vec(size, arma::fill::zeros));
+        for (int m = 0; m < length; m++)
+            source_table.Apply(time_point_vec[n_0 + m + 1], b_vec[m]);
+
+        // Column 0 is the window start, the first guess holds it.
+        mat X_old(size, length + 1);
+        X_old.each_col() = tran_result_mat.col(n_0);
+        mat X_new = X_old;
+        vector<int> fail_num(part_num, 0);
+
+        // Each block writes only its own rows of X_new, each thread counts into
+        // its own statistics.
+        auto worker = [&](int first, int stride) {
+            RunStatistics& stat = stat_vec[first];
+            for (int k = first; k < part_num; k += stride) {
+                TranPartition& part = part_vec[k];
+                NewtonSetting newton_setting(options);
+                newton_setting.lu = &part.lu_map[1];
+                newton_setting.stat = &stat;
+                vec x_prev = X_old.col(0);
+                for (int m = 1; m <= length; m++) {
+                    const uvec col = {arma::uword(m)};
+                    vec rhs =
+                        RHS_gen.rows(part.index) * x_prev + b_vec[m - 1](part.index);
+                    if (!part.other.is_empty())
+                        rhs -= coupling_vec[k] * vec(X_old(part.other, col));
+
+                    vec x = x_prev(part.index);
+                    if (!part.nonlinear) {
+                        x = part.lu_map[1].Solve(rhs);
+                        stat.solve_num++;
+                    } else {
+                        part.system.rhs = rhs;
+                        int iter_num = 0;
+                        if (!NewtonSolve(part.system, newton_setting, x, iter_num))
+                            fail_num[k]++;
+                    }
+                    X_new(part.index, col) = x;
+
+                    x_prev = X_old.col(m);
+                    x_prev(part.index) = x;
+                }
+            }
+        };
+
+        int sweep = 0;
+        bool converged = false;
+        while (!converged && sweep < WR_MAX_ITER) {
+            sweep++;
+            vector<std::thread> thread_vec;
+            for (int t = 1; t < thread_num; t++)
+                thread_vec.push_back(std::thread(worker, t, thread_num));
+            worker(0, thread_num);
+            for (std::thread& thread : thread_vec)
+                thread.join();
+
+            converged = true;
+            for (int m = 1; m <= length && converged; m++)
+                converged =
+                    CheckUpdate(X_old.col(m), X_new.col(m), voltage_num, criteria);
+            X_old = X_new;
+        }
+        for (int k = 0; k < part_num; k++)
+            if (fail_num[k] > 0)
+                cout << "Newton failed " << fail_num[k] << " times in partition " << k
+                     << " before t = " << time_point_vec[n_1] << endl;
+        if (!converged)
+            cout << "Waveform relaxation not converged in window ending at t = "
+                 << time_point_vec[n_1] << endl;
+
+        sweep_sum += sweep;
+        max_sweep = std::max(max_sweep, sweep);
+        tran_result_mat.cols(n_0 + 1, n_1) = X_new.cols(1, length);
+    }
+    tran_result = TranResult{tran_result_mat, time_point_vec, node_vec};
+    for (const RunStatistics& stat : stat_vec)
+        run_stat.Add(stat);
+
+    cout << "Waveform relaxation: " << part_num << " partitions on " << thread_num
+         << " threads, " << window_num << " windows, " << sweep_sum << " sweeps (at most "
+         << max_sweep << " per window)" << endl;
+    return true;
+}
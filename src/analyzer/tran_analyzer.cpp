@@ -13,95 +13,194 @@ using arma::vec;
 using std::cout;
 using std::endl;
 
-TranAnalysisMat BackEuler(const Circuit circuit, const double h);
+// Transient steps are cut at a source breakpoint unless it is within this
+// fraction of a step from the grid.
+constexpr double BREAKPOINT_TOL = 1e-3;
+
 TranAnalysisMat TrapezoidalRule(const Circuit circuit, const double h);
 
-double GetVsrcValue(const Vsrc vsrc, double t);
 double GetPulseValue(const Pulse pulse, double t);
 double GetSinValue(const Sin sin, double t);
 
 // TODO: only support RCL.
 void Analyzer::DoTranAnalysis(const TranAnalysis tran_analysis) {
+    if (options.tran_method == EXPINT) {
+        if (circuit.diode_vec.empty()) {
+            DoExpTranAnalysis(tran_analysis);
+            return;
+        }
+        cout << "method=expint needs a linear circuit, using Backward Euler" << endl;
+    } else if (options.tran_method == MULTIRATE) {
+        DoMultirateTranAnalysis(tran_analysis);
+        return;
+    } else if (options.tran_method == WR) {
+        if (DoWrTranAnalysis(tran_analysis))
+            return;
+        cout << "method=wr found a single partition, using Backward Euler" << endl;
+    } else if (options.tran_method == PARAREAL) {
+        DoPararealTranAnalysis(tran_analysis);
+        return;
+    }
+
     double t_start = tran_analysis.t_start;
     double t_stop = tran_analysis.t_stop;
     double t_step = tran_analysis.t_step;
     int scan_num = (t_stop - t_start) / t_step;
 
-    TranAnalysisMat tran_analysis_mat = BackEuler(circuit, t_step);
-
-    int total_node_num = tran_analysis_mat.node_vec.size();
-
-    // Remove the ground node
-    mat MNA =
-        tran_analysis_mat.MNA(span(1, total_node_num - 1), span(1, total_node_num - 1));
-
-    std::vector<NodeName> MNA_node_vec = tran_analysis_mat.node_vec;
-    std::vector<NodeName>::iterator h = MNA_node_vec.begin();
-    MNA_node_vec.erase(h);
+    TranStepper stepper;
+    if (!InitTranStepper(t_step, stepper))
+        return;
 
-    mat RHS_gen = tran_analysis_mat.RHS_gen(span(1, total_node_num - 1),
-                                            span(1, total_node_num - 1));
+    // Steps are cut at the source corners, which are added to the output.
+    BreakpointQueue breakpoint_queue;
+    breakpoint_queue.Init(circuit.vsrc_vec, t_start);
+    const double tol = BREAKPOINT_TOL * t_step;
+    int corner_num = 0;
+    // The off-grid steps of a periodic source repeat every period, so their
+    // steppers are kept, by step length in units of BREAKPOINT_TOL * tol.
+    std::map<long, TranStepper> sub_stepper_map;
 
-    mat tran_result_mat(total_node_num - 1, scan_num + 1, arma::fill::zeros);
+    std::vector<vec> result_vec = {GetTranInitialState(tran_analysis, stepper.node_vec)};
     std::vector<double> time_point_vec;
 
     time_point_vec.push_back(t_start);
 
-    // cout << "MNA: " << endl << MNA << endl;
-    // cout << "RHS_gen: " << endl << RHS_gen << endl;
-
     for (int i = 0; i < scan_num; i++) {
-        time_point_vec.push_back(t_start + (i + 1) * t_step);
+        const double t_next = t_start + (i + 1) * t_step;
+
+        while (true) {
+            double t = time_point_vec.back();
+            double t_corner = breakpoint_queue.NextAfter(t, tol);
+            bool corner = t_corner < t_next - tol;
+            double t_end = corner ? t_corner : t_next;
+
+            vec tran_result;
+            int iter_num = 0;
+            bool converged;
+            // Off-grid steps get their own Backward Euler matrix.
+            if (t_end - t > t_step - tol)
+                converged = TranStep(stepper, t_end, result_vec.back(), tran_result,
+                                     iter_num);
+            else {
+                long key = std::lround((t_end - t) / (BREAKPOINT_TOL * tol));
+                if (!sub_stepper_map.count(key) &&
+                    !InitTranStepper(t_end - t, sub_stepper_map[key]))
+                    return;
+                converged = TranStep(sub_stepper_map[key], t_end, result_vec.back(),
+                                     tran_result, iter_num);
+            }
+            if (!converged)
+                cout << "Newton failed to converge at t = " << t_end << " after "
+                     << iter_num << " iterations" << endl;
+
+            time_point_vec.push_back(t_end);
+            result_vec.push_back(tran_result);
+            if (!corner)
+                break;
+            corner_num++;
+        }
+    }
+    if (corner_num > 0)
+        cout << "Landed on " << corner_num << " source breakpoints" << endl;
 
-        mat RHS_t_h = RHS_gen * tran_result_mat.col(i);
+    mat tran_result_mat(stepper.MNA.n_rows, result_vec.size());
+    for (std::size_t i = 0; i < result_vec.size(); i++)
+        tran_result_mat.col(i) = result_vec[i];
+    tran_result = TranResult{tran_result_mat, time_point_vec, stepper.node_vec};
+}
 
-        // voltage source up
-        for (auto vsrc : circuit.vsrc_vec) {
-            int index = FindNode(MNA_node_vec, "i_" + vsrc.name);
-            double value = GetVsrcValue(vsrc, t_start + (i + 1) * t_step);
-            RHS_t_h(index, 0) = value;
-        }
+/**
+ * @brief Build the Backward Euler system with step h and its solvers. The
+ * linear MNA is factorized here once for the whole run, and chord Newton can
+ * keep the Jacobian of the previous step.
+ *
+ * @param h
+ * @param stepper
+ * @return false: the linear MNA is singular
+ */
+bool Analyzer::InitTranStepper(const double h, TranStepper& stepper) {
+    TranAnalysisMat tran_analysis_mat = BackEuler(circuit, h);
 
-        // Source source up
-        for (auto isrc : circuit.isrc_vec) {
-            int node_1_index = FindNode(MNA_node_vec, isrc.node_1);
-            int node_2_index = FindNode(MNA_node_vec, isrc.node_2);
-            if (node_1_index >= 0)
-                RHS_t_h(node_1_index, 0) += -1 * isrc.tran_const_value;
-            if (node_2_index >= 0)
-                RHS_t_h(node_2_index, 0) += 1 * isrc.tran_const_value;
-        }
+    int total_node_num = tran_analysis_mat.node_vec.size();
 
-        vec tran_result;
-
-        if (!circuit.diode_vec.empty()) {
-            // Nonlinear
-            vec result_n(total_node_num - 1, arma::fill::zeros);
-            vec result_n_plus_1(total_node_num - 1, arma::fill::zeros);
-
-            while (true) {
-                // Update the analysis matrix
-                mat mna = AddExpTerm(tran_analysis_mat.exp_analysis_vec, result_n, MNA);
-                // Update RHS
-                mat rhs = AddExpTerm(tran_analysis_mat.exp_rhs_vec, result_n, RHS_t_h);
-                // cout << "reduced_mat:" << endl << MNA << endl;
-                // cout << "scan_rhs" << endl << RHS_t_h << endl;
-
-                result_n_plus_1 = arma::solve(mna, rhs, arma::solve_opts::allow_ugly);
-                if (VecDifference(result_n, result_n_plus_1))
-                    break;
-                result_n = result_n_plus_1;
-            }
-            tran_result = result_n_plus_1;
-        }
-        // Linear
-        else {
-            tran_result = arma::solve(MNA, RHS_t_h);
+    // Remove the ground node
+    stepper.h = h;
+    stepper.MNA =
+        tran_analysis_mat.MNA(span(1, total_node_num - 1), span(1, total_node_num - 1));
+    stepper.RHS_gen = tran_analysis_mat.RHS_gen(span(1, total_node_num - 1),
+                                                span(1, total_node_num - 1));
+
+    stepper.node_vec = tran_analysis_mat.node_vec;
+    stepper.node_vec.erase(stepper.node_vec.begin());
+    stepper.source_table.Build(circuit, stepper.node_vec);
+
+    stepper.newton_system =
+        NewtonSystem(stepper.MNA, tran_analysis_mat.exp_analysis_vec, mat(),
+                     tran_analysis_mat.exp_rhs_vec, circuit.node_vec.size() - 1);
+    stepper.newton_setting = NewtonSetting(options);
+    stepper.newton_setting.stat = &run_stat;
+    stepper.lu.valid = false;
+
+    if (circuit.diode_vec.empty()) {
+        run_stat.factorization_num++;
+        if (!stepper.lu.Factorize(stepper.MNA)) {
+            cout << "Singular MNA matrix, no transient" << endl;
+            return false;
         }
+        return true;
+    }
+
+    // The linear-only unknowns are eliminated once for the whole run.
+    stepper.use_schur = !circuit.diode_vec.empty() &&
+                        BuildSchurSystem(stepper.newton_system, stepper.schur);
+    if (stepper.use_schur)
+        run_stat.factorization_num++;
+    return true;
+}
+
+/**
+ * @brief One Backward Euler step from x_prev to time t. Counters go to
+ * stepper.newton_setting.stat, so steppers on other threads can keep their own.
+ *
+ * @param stepper
+ * @param t the end of the step
+ * @param x_prev
+ * @param x_next also the Newton starting point if it has the right size
+ * @param iter_num Newton iterations
+ * @return false: Newton failed to converge
+ */
+bool Analyzer::TranStep(TranStepper& stepper, const double t, const vec& x_prev,
+                        vec& x_next, int& iter_num) {
+    vec RHS_t_h = stepper.RHS_gen * x_prev;
+    stepper.source_table.Apply(t, RHS_t_h);
+
+    iter_num = 0;
+    // Linear
+    RunStatistics* stat = stepper.newton_setting.stat;
+    if (circuit.diode_vec.empty()) {
+        x_next = stepper.lu.Solve(RHS_t_h);
+        if (stat)
+            stat->solve_num++;
+        return true;
+    }
 
-        tran_result_mat.col(i + 1) = tran_result;
+    // Nonlinear, starting from the previous time point
+    if (x_next.n_elem != x_prev.n_elem)
+        x_next = x_prev;
+    NewtonSetting newton_setting = stepper.newton_setting;
+    newton_setting.lu = &stepper.lu;
+
+    bool converged;
+    if (stepper.use_schur) {
+        SetSchurRhs(stepper.schur, RHS_t_h);
+        vec x = GetSchurNonlinearPart(stepper.schur, x_next);
+        converged = NewtonSolve(stepper.schur.reduced, newton_setting, x, iter_num);
+        x_next = RecoverSchurSolution(stepper.schur, x);
+    } else {
+        stepper.newton_system.rhs = RHS_t_h;
+        converged = NewtonSolve(stepper.newton_system, newton_setting, x_next, iter_num);
     }
-    tran_result = TranResult{tran_result_mat, time_point_vec, MNA_node_vec};
+    return converged;
 }
 
 TranAnalysisMat BackEuler(const Circuit circuit, const double h) {
@@ -190,23 +289,7 @@ TranAnalysisMat BackEuler(const Circuit circuit, const double h) {
     // Add Diode stamps
     std::vector<ExpTerm> exp_analysis_vec;
     std::vector<ExpTerm> exp_rhs_vec;
-    for (Diode diode : circuit.diode_vec) {
-        int node_1_index = FindNode(circuit.node_vec, diode.node_1);
-        int node_2_index = FindNode(circuit.node_vec, diode.node_2);
-        exp_analysis_vec.push_back(ExpTerm(node_1_index, node_1_index, node_1_index,
-                                           node_2_index, ExpCoeff(40, 40)));
-        exp_analysis_vec.push_back(ExpTerm(node_1_index, node_2_index, node_1_index,
-                                           node_2_index, ExpCoeff(-40, 40)));
-        exp_analysis_vec.push_back(ExpTerm(node_2_index, node_1_index, node_1_index,
-                                           node_2_index, ExpCoeff(-40, 40)));
-        exp_analysis_vec.push_back(ExpTerm(node_2_index, node_2_index, node_1_index,
-                                           node_2_index, ExpCoeff(40, 40)));
-
-        exp_rhs_vec.push_back(ExpTerm(node_1_index, node_1_index, node_2_index,
-                                      ExpCoeff(-1, 40, 1), ExpCoeff(40, 40)));
-        exp_rhs_vec.push_back(ExpTerm(node_2_index, node_1_index, node_2_index,
-                                      ExpCoeff(1, 40, -1), ExpCoeff(-40, 40)));
-    }
+    AddDiodeStamps(circuit, exp_analysis_vec, exp_rhs_vec);
 
     TranAnalysisMat tran_analysis_mat(MNA, exp_analysis_vec, modified_node_vec, RHS_gen,
                                       exp_rhs_vec);
@@ -1,11 +1,33 @@
 #include <QApplication>
 #include <QLabel>
+#include <QTextEdit>
 
 #include "mainwindow/mainwindow.h"
 
+using std::cout;
+using std::endl;
+
 int main(int argc, char* argv[]) {
     QApplication app(argc, argv);
 
+    // simpleEDA netlist.sp runs the netlist without the window and writes the
+    // .print variables to cout, e.g. for testbench/check.py.
+    QStringList argument_list = app.arguments();
+    if (argument_list.size() > 1) {
+        QTextEdit output;
+        Parser parser(&output);
+        if (!parser.ParseFile(argument_list[1])) {
+            cout << "Cannot read " << argument_list[1] << endl;
+            return 1;
+        }
+        if (!parser.ParserFinalCheck()) {
+            cout << "Parser check failed" << endl;
+            return 1;
+        }
+        Analyzer analyzer(parser, false);
+        return 0;
+    }
+
     MainWindow* mainwindow = new MainWindow;
     mainwindow->show();
 
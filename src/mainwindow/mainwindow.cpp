@@ -203,38 +203,12 @@ void MainWindow::SlotParser() {
 
     parser = Parser(output);
 
-    QFile file(file_name);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!parser.ParseFile(file_name)) {
         QMessageBox::warning(this, tr("Error"),
                              tr("Load the content in SPICE file failed."),
                              QMessageBox::Ok);
         return;
     }
-    QTextStream textStream(&file);
-
-    QString title;
-
-    int lineCount = 0;
-    while (!textStream.atEnd()) {
-        QString line = textStream.readLine();
-        lineCount++;
-        if (lineCount == 1) {
-            title = line;
-            cout << "Parsed Title: " << title << endl;
-            output->append(tr("Parsed Title: ") + title);
-        } else if (line.size() > 0) {
-            if (line.startsWith("*")) {
-                cout << "Parsed Annotation: " << line << endl;
-                output->append(tr("Parsed Annotation: ") + line);
-            } else {
-                line = line.toLower();  // SPICE is case-insensistive
-                if (line.startsWith("."))
-                    parser.CommandParser(line, lineCount);
-                else
-                    parser.DeviceParser(line, lineCount);
-            }
-        }
-    }
 
     Circuit circuit = parser.GetCircuit();
 
@@ -7,6 +7,11 @@
 
 #include "parser.h"
 
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+
 #include "../utils/utils.h"
 
 using std::cout;
@@ -18,17 +23,56 @@ Parser::Parser() {
     command_op = false;
     command_end = false;
     analysis_type = NONE;
+    dc_analysis = DcAnalysis();
 }
 
 Parser::Parser(QTextEdit* output) {
     command_op = false;
     command_end = false;
     analysis_type = NONE;
+    dc_analysis = DcAnalysis();
     this->output = output;
 }
 
 Parser::~Parser() {}
 
+/**
+ * @brief Parse a netlist file: the title on the first line, then `*`
+ * comments, dot commands and devices. SPICE is case-insensitive, so every
+ * other line is lowered first.
+ *
+ * @param file_name
+ * @return false: the file cannot be read
+ */
+bool Parser::ParseFile(const QString file_name) {
+    QFile file(file_name);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+    QTextStream textStream(&file);
+
+    int lineCount = 0;
+    while (!textStream.atEnd()) {
+        QString line = textStream.readLine();
+        lineCount++;
+        if (lineCount == 1) {
+            cout << "Parsed Title: " << line << endl;
+            output->append(QString("Parsed Title: ") + line);
+        } else if (line.size() > 0) {
+            if (line.startsWith("*")) {
+                cout << "Parsed Annotation: " << line << endl;
+                output->append(QString("Parsed Annotation: ") + line);
+            } else {
+                line = line.toLower();
+                if (line.startsWith("."))
+                    CommandParser(line, lineCount);
+                else
+                    DeviceParser(line, lineCount);
+            }
+        }
+    }
+    return true;
+}
+
 void Parser::DeviceParser(const QString line, const int lineNum) {
     QStringList elements = line.split(" ");
     int num_elements = elements.length();
@@ -391,20 +435,7 @@ void Parser::DeviceParser(const QString line, const int lineNum) {
 
             NodeName node_1 = ReadNodeName(elements[1]);
             NodeName node_2 = ReadNodeName(elements[2]);
-            ModelName model = elements[3];
-
-            bool known_model = false;
-            for (auto d_model : diode_model_lut) {
-                if (d_model.model == model) {
-                    known_model = true;
-                    break;
-                }
-            }
-
-            if (!known_model) {
-                ParseError("unknown model", device_name, lineNum);
-                return;
-            }
+            ModelName model = elements[3];  // checked at the end, .model may follow
 
             circuit.diode_vec.push_back(Diode(device_name, node_1, node_2, model));
 
@@ -437,7 +468,7 @@ void Parser::CommandParser(const QString line, const int lineNum) {
             ParseError("", ".op", lineNum);
         else {
             command_op = true;
-            analysis_type = DC;
+            analysis_type = OP;
             cout << "Parsed Analysis Command .OP Token" << endl;
         }
     }
@@ -482,6 +513,193 @@ void Parser::CommandParser(const QString line, const int lineNum) {
             PrintCommandParser(elements);
         }
     }
+    // .options
+    else if (command == ".options" || command == ".option") {
+        if (num_elements == 1)
+            ParseError("need parameters", command, lineNum);
+        else {
+            elements.removeFirst();
+            OptionsCommandParser(elements, lineNum);
+        }
+    }
+    // .fault [device ...]
+    else if (command == ".fault") {
+        analysis_type = FAULT;
+        fault_analysis.device_vec.clear();
+        for (int i = 1; i < num_elements; i++) {
+            DeviceName name = elements[i];
+            if (CheckNameRepetition<Res>(circuit.res_vec, name) ||
+                CheckNameRepetition<Cap>(circuit.cap_vec, name) ||
+                CheckNameRepetition<Ind>(circuit.ind_vec, name) ||
+                CheckNameRepetition<Vsrc>(circuit.vsrc_vec, name) ||
+                CheckNameRepetition<Isrc>(circuit.isrc_vec, name) ||
+                CheckNameRepetition<VCCS>(circuit.vccs_vec, name) ||
+                CheckNameRepetition<VCVS>(circuit.vcvs_vec, name))
+                fault_analysis.device_vec.push_back(name);
+            else
+                ParseError("target device not exists", ".fault", lineNum);
+        }
+        cout << "Parsed Analysis Command FAULT (Devices: ";
+        if (fault_analysis.device_vec.empty())
+            cout << "all";
+        for (DeviceName name : fault_analysis.device_vec)
+            cout << name << " ";
+        cout << ")" << endl;
+    }
+    // .alter device value
+    else if (command == ".alter") {
+        if (num_elements != 3) {
+            ParseError("", ".alter", lineNum);
+            return;
+        }
+        DeviceName name = elements[1];
+        double value = ParseValue(elements[2]);
+        if (!(CheckNameRepetition<Res>(circuit.res_vec, name) ||
+              CheckNameRepetition<Cap>(circuit.cap_vec, name) ||
+              CheckNameRepetition<Ind>(circuit.ind_vec, name) ||
+              CheckNameRepetition<Vsrc>(circuit.vsrc_vec, name) ||
+              CheckNameRepetition<Isrc>(circuit.isrc_vec, name) ||
+              CheckNameRepetition<VCCS>(circuit.vccs_vec, name) ||
+              CheckNameRepetition<VCVS>(circuit.vcvs_vec, name)))
+            ParseError("target device not exists", ".alter", lineNum);
+        else if (value == MAGIC)
+            ParseError("invalid value", ".alter", lineNum);
+        else {
+            alter_vec.push_back({name, value});
+            cout << "Parsed Command ALTER (Device: " << name << "; Value: " << value
+                 << ")" << endl;
+        }
+    }
+    // .model name d [is=value] [n=value] [tt=value] [cj0=value]
+    else if (command == ".model") {
+        if (num_elements < 3)
+            ParseError("", ".model", lineNum);
+        else
+            ModelCommandParser(elements, lineNum);
+    }
+    // .sens v(node) ...
+    else if (command == ".sens") {
+        if (num_elements == 1) {
+            ParseError("need parameters", ".sens", lineNum);
+            return;
+        }
+        QRegularExpression bracket_re("(?<=\\().*(?=\\))");
+        sens_analysis.output_vec.clear();
+        for (int i = 1; i < num_elements; i++) {
+            QRegularExpressionMatch match_node = bracket_re.match(elements[i]);
+            if (!elements[i].startsWith("v") || !match_node.hasMatch()) {
+                ParseError("invalid output", elements[i], lineNum);
+                return;
+            }
+            sens_analysis.output_vec.push_back(match_node.captured());
+        }
+        analysis_type = SENS;
+        cout << "Parsed Analysis Command SENS (Outputs: ";
+        for (NodeName node : sens_analysis.output_vec)
+            cout << node << " ";
+        cout << ")" << endl;
+    }
+    // .tf v(node_1[,node_2]) src / .tf i(vsrc) src
+    else if (command == ".tf") {
+        if (num_elements != 3)
+            ParseError("", ".tf", lineNum);
+        else if (TransferCommandParser(elements, lineNum, tf_analysis)) {
+            analysis_type = TF;
+            cout << "Parsed Analysis Command TF (Output: " << elements[1] << "; "
+                 << "Input: " << tf_analysis.src_name << ")" << endl;
+        }
+    }
+    // .pz v(node_1[,node_2]) src / .pz i(vsrc) src
+    else if (command == ".pz") {
+        if (num_elements != 3)
+            ParseError("", ".pz", lineNum);
+        else if (TransferCommandParser(elements, lineNum, pz_analysis)) {
+            analysis_type = PZ;
+            cout << "Parsed Analysis Command PZ (Output: " << elements[1] << "; "
+                 << "Input: " << pz_analysis.src_name << ")" << endl;
+        }
+    }
+    // .noise v(node_1[,node_2]) src dec|oct|lin points f_start f_end
+    else if (command == ".noise") {
+        if (num_elements != 7)
+            ParseError("", ".noise", lineNum);
+        else if (TransferCommandParser(elements, lineNum, noise_analysis.transfer)) {
+            AcAnalysis& sweep = noise_analysis.sweep;
+            sweep.variation_type = LIN;
+            for (uint i = 0; i < AcVariationType_lookup.size(); i++) {
+                if (elements[3] == qstr(AcVariationType_lookup[i])) {
+                    sweep.variation_type = static_cast<AcVariationType>(i);
+                    break;
+                }
+            }
+            sweep.point_num = ParseValue(elements[4]);
+            sweep.f_start = ParseValue(elements[5]);
+            sweep.f_end = ParseValue(elements[6]);
+            analysis_type = NOISE;
+
+            cout << "Parsed Analysis Command NOISE (Output: " << elements[1] << "; "
+                 << "Input: " << noise_analysis.transfer.src_name << "; "
+                 << "Variation Type: " << AcVariationType_lookup[sweep.variation_type]
+                 << "; "
+                 << "Points: " << sweep.point_num << "; "
+                 << "f_Start: " << sweep.f_start << "; "
+                 << "f_End: " << sweep.f_end << ")" << endl;
+        }
+    }
+    // .hb f0 harmonic_num
+    else if (command == ".hb") {
+        if (num_elements != 3)
+            ParseError("", ".hb", lineNum);
+        else {
+            hb_analysis.f0 = ParseValue(elements[1]);
+            hb_analysis.harmonic_num = ParseValue(elements[2]);
+            if (hb_analysis.f0 <= 0 || hb_analysis.harmonic_num < 1)
+                ParseError("f0 and harmonic number must be positive", ".hb", lineNum);
+            else {
+                analysis_type = DISTO;
+                cout << "Parsed Analysis Command HB (f0: " << hb_analysis.f0 << "; "
+                     << "Harmonics: " << hb_analysis.harmonic_num << ")" << endl;
+            }
+        }
+    }
+    // .pss t_step period
+    else if (command == ".pss") {
+        if (num_elements != 3)
+            ParseError("", ".pss", lineNum);
+        else {
+            pss_analysis.t_step = ParseValue(elements[1]);
+            pss_analysis.period = ParseValue(elements[2]);
+            if (pss_analysis.t_step <= 0 || pss_analysis.period < pss_analysis.t_step)
+                ParseError("period must be at least one time step", ".pss", lineNum);
+            else {
+                analysis_type = PSS;
+                cout << "Parsed Analysis Command PSS (Tstep: " << pss_analysis.t_step
+                     << "; Period: " << pss_analysis.period << ")" << endl;
+            }
+        }
+    }
+    // .ic v(node)=value ...
+    else if (command == ".ic") {
+        if (num_elements == 1)
+            ParseError("need parameters", ".ic", lineNum);
+        else if (NodeVoltageParser(elements, lineNum, ic_vec)) {
+            cout << "Parsed Command IC (";
+            for (NodeVoltage ic : ic_vec)
+                cout << ic.node << ": " << ic.value << "; ";
+            cout << ")" << endl;
+        }
+    }
+    // .nodeset v(node)=value ...
+    else if (command == ".nodeset") {
+        if (num_elements == 1)
+            ParseError("need parameters", ".nodeset", lineNum);
+        else if (NodeVoltageParser(elements, lineNum, nodeset_vec)) {
+            cout << "Parsed Command NODESET (";
+            for (NodeVoltage nodeset : nodeset_vec)
+                cout << nodeset.node << ": " << nodeset.value << "; ";
+            cout << ")" << endl;
+        }
+    }
     // TODO: complete the logic
     else if (command == ".dc") {
         if (num_elements != 5)
@@ -535,6 +753,12 @@ void Parser::CommandParser(const QString line, const int lineNum) {
 
     // .tran
     else if (command == ".tran") {
+        // .tran ... uic
+        bool uic = elements.last() == "uic";
+        if (uic) {
+            elements.removeLast();
+            num_elements--;
+        }
         switch (num_elements) {
             // .tran tstep tstop
             case 3: {
@@ -560,12 +784,211 @@ void Parser::CommandParser(const QString line, const int lineNum) {
                 return;
             }
         }
+        tran_analysis.uic = uic;
         cout << "Parsed Analysis Command TRAN "
              << "(Tstep: " << tran_analysis.t_step << "; tstop: " << tran_analysis.t_stop
-             << "; tstart: " << tran_analysis.t_start << " )" << endl;
+             << "; tstart: " << tran_analysis.t_start << (uic ? "; UIC" : "") << " )"
+             << endl;
+    }
+}
+
+/**
+ * @brief Parser for the options of .options
+ *
+ * @param elements options without the leading .options
+ * @param lineNum
+ */
+void Parser::OptionsCommandParser(const QStringList elements, const int lineNum) {
+    for (QString e : elements) {
+        if (e == "ptran" || e == "chord" || e == "opcache" || e == "noopcache") {
+            if (e == "ptran")
+                sim_options.pseudo_tran = true;
+            else if (e == "chord")
+                sim_options.chord = true;
+            else
+                sim_options.op_cache = e == "opcache";
+            cout << "Parsed Option " << e << endl;
+            continue;
+        }
+
+        // name=value
+        QStringList name_value = e.split("=");
+        if (name_value.length() != 2) {
+            ParseError("unknown option", e, lineNum);
+            continue;
+        }
+        QString name = name_value[0];
+        if (name == "method") {
+            bool found = false;
+            for (uint i = 0; i < TranMethod_lookup.size(); i++) {
+                if (name_value[1] == qstr(TranMethod_lookup[i])) {
+                    sim_options.tran_method = static_cast<TranMethod>(i);
+                    found = true;
+                }
+            }
+            if (found)
+                cout << "Parsed Option method = " << name_value[1] << endl;
+            else
+                ParseError("unknown method", e, lineNum);
+            continue;
+        }
+        double value = ParseValue(name_value[1]);
+        if (value == MAGIC) {
+            ParseError("invalid value", e, lineNum);
+            continue;
+        }
+
+        if (name == "vntol")
+            sim_options.vntol = value;
+        else if (name == "abstol")
+            sim_options.abstol = value;
+        else if (name == "reltol")
+            sim_options.reltol = value;
+        else if (name == "itl1") {
+            if (value < 1 || value != std::floor(value)) {
+                ParseError("itl1 must be a positive integer", e, lineNum);
+                continue;
+            }
+            sim_options.itl1 = value;
+        }
+        else {
+            ParseError("unknown option", e, lineNum);
+            continue;
+        }
+        cout << "Parsed Option " << name << " = " << value << endl;
     }
 }
 
+/**
+ * @brief Parser for the `v(node)=value` pairs of .ic and .nodeset. A node
+ * given again takes the later value, and gnd cannot be given.
+ *
+ * @param elements `command v(node)=value ...`
+ * @param lineNum
+ * @param node_voltage_vec the pairs are added to it
+ * @return false: a pair is invalid, none of the line is added
+ */
+bool Parser::NodeVoltageParser(const QStringList elements, const int lineNum,
+                               std::vector<NodeVoltage>& node_voltage_vec) {
+    QRegularExpression pair_re("^v\\((.+)\\)=(.+)$");
+    std::vector<NodeVoltage> line_vec;
+    for (int i = 1; i < elements.length(); i++) {
+        QRegularExpressionMatch match = pair_re.match(elements[i]);
+        double value = match.hasMatch() ? ParseValue(match.captured(2)) : MAGIC;
+        if (value == MAGIC) {
+            ParseError("invalid node voltage", elements[i], lineNum);
+            return false;
+        }
+        NodeName node = ReadNodeName(match.captured(1));
+        if (node == "0") {
+            ParseError("gnd is always at 0 V", elements[i], lineNum);
+            return false;
+        }
+        line_vec.push_back({node, value});
+    }
+
+    for (NodeVoltage node_voltage : line_vec) {
+        auto same = [&node_voltage](const NodeVoltage& other) {
+            return other.node == node_voltage.node;
+        };
+        node_voltage_vec.erase(std::remove_if(node_voltage_vec.begin(),
+                                              node_voltage_vec.end(), same),
+                               node_voltage_vec.end());
+        node_voltage_vec.push_back(node_voltage);
+    }
+    return true;
+}
+
+/**
+ * @brief Parser for .model. Only diode models are known, with the saturation
+ * current and emission coefficient of their DC current and the transit time
+ * and junction capacitance of their small-signal model.
+ *
+ * @param elements `.model name d param=value ...`
+ * @param lineNum
+ */
+void Parser::ModelCommandParser(const QStringList elements, const int lineNum) {
+    ModelName model = elements[1];
+    if (elements[2] != "d") {
+        ParseError("only diode models are supported", model, lineNum);
+        return;
+    }
+    for (DiodeModel d_model : circuit.diode_model_vec) {
+        if (d_model.model == model) {
+            ParseError("already exits", model, lineNum);
+            return;
+        }
+    }
+
+    DiodeModel d_model = diode_model_lut.front();
+    d_model.model = model;
+    for (int i = 3; i < elements.length(); i++) {
+        QStringList name_value = elements[i].split("=");
+        double value = name_value.length() == 2 ? ParseValue(name_value[1]) : MAGIC;
+        if (value == MAGIC || value < 0) {
+            ParseError("invalid model parameter", elements[i], lineNum);
+            return;
+        }
+        if ((name_value[0] == "is" || name_value[0] == "n") && value == 0) {
+            ParseError("is and n must be positive", elements[i], lineNum);
+            return;
+        }
+        if (name_value[0] == "is")
+            d_model.i_sat = value;
+        else if (name_value[0] == "n")
+            d_model.n = value;
+        else if (name_value[0] == "tt")
+            d_model.tt = value;
+        else if (name_value[0] == "cj0")
+            d_model.cj0 = value;
+        else {
+            ParseError("unknown model parameter", elements[i], lineNum);
+            return;
+        }
+    }
+    circuit.diode_model_vec.push_back(d_model);
+
+    cout << "Parsed Command MODEL (Name: " << model << "; Type: d; "
+         << "is: " << d_model.i_sat << "; n: " << d_model.n << "; "
+         << "tt: " << d_model.tt << "; cj0: " << d_model.cj0 << ")" << endl;
+}
+
+/**
+ * @brief Parser for the output and input of .tf and .pz
+ *
+ * @param elements `command output src`
+ * @param lineNum
+ * @param tf_analysis filled in on success
+ * @return true: both the output and the input source exist
+ */
+bool Parser::TransferCommandParser(const QStringList elements, const int lineNum,
+                                   TfAnalysis& tf_analysis) {
+    QRegularExpression bracket_re("(?<=\\().*(?=\\))");
+    QRegularExpressionMatch match_node = bracket_re.match(elements[1]);
+    if (!(elements[1].startsWith("v") || elements[1].startsWith("i")) ||
+        !match_node.hasMatch()) {
+        ParseError("invalid output", elements[1], lineNum);
+        return false;
+    }
+    QStringList node_list = match_node.captured().split(",");
+    tf_analysis.out_i_v = elements[1].startsWith("v") ? V : I;
+    tf_analysis.out_node_1 = node_list[0];
+    tf_analysis.out_node_2 = node_list.length() > 1 ? node_list[1] : QString("0");
+    if (tf_analysis.out_i_v == I &&
+        !CheckNameRepetition<Vsrc>(circuit.vsrc_vec, tf_analysis.out_node_1)) {
+        ParseError("output voltage source not exists", elements[0], lineNum);
+        return false;
+    }
+
+    tf_analysis.src_name = elements[2];
+    if (!CheckNameRepetition<Vsrc>(circuit.vsrc_vec, tf_analysis.src_name) &&
+        !CheckNameRepetition<Isrc>(circuit.isrc_vec, tf_analysis.src_name)) {
+        ParseError("input source not exists", elements[0], lineNum);
+        return false;
+    }
+    return true;
+}
+
 // TODO: This method is far from complete.
 void Parser::PrintCommandParser(const QStringList elements) {
     NodeName node;
@@ -763,6 +1186,23 @@ bool Parser::CheckGndNode() {
     return false;
 }
 
+bool Parser::CheckDiodeModel() {
+    for (Diode diode : circuit.diode_vec) {
+        bool known_model = false;
+        for (DiodeModel d_model : circuit.diode_model_vec) {
+            if (d_model.model == diode.model) {
+                known_model = true;
+                break;
+            }
+        }
+        if (!known_model) {
+            cout << "Unknown model " << diode.model << " of " << diode.name << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 // TODO: Need more checks
 /**
  * @brief Parser check
@@ -772,7 +1212,7 @@ bool Parser::CheckGndNode() {
  */
 bool Parser::ParserFinalCheck() {
     if (command_end)
-        return CheckGndNode();
+        return CheckGndNode() && CheckDiodeModel();
     else
         return false;
 }
\ No newline at end of file
@@ -23,6 +23,7 @@ class Parser {
     Parser();
     Parser(QTextEdit* output);
     ~Parser();
+    bool ParseFile(const QString file_name);
     void DeviceParser(const QString line, const int lineNum);
     void CommandParser(const QString line, const int lineNum);
 
@@ -35,7 +36,18 @@ class Parser {
     auto GetDcAnalysis() { return dc_analysis; }
     auto GetAcAnalysis() { return ac_analysis; }
     auto GetTranAnalysis() { return tran_analysis; }
+    auto GetFaultAnalysis() { return fault_analysis; }
+    auto GetSensAnalysis() { return sens_analysis; }
+    auto GetTfAnalysis() { return tf_analysis; }
+    auto GetPzAnalysis() { return pz_analysis; }
+    auto GetNoiseAnalysis() { return noise_analysis; }
+    auto GetHbAnalysis() { return hb_analysis; }
+    auto GetPssAnalysis() { return pss_analysis; }
     auto GetPrintVariables() { return print_variable_vec; }
+    auto GetInitialConditions() { return ic_vec; }
+    auto GetNodesets() { return nodeset_vec; }
+    auto GetAlters() { return alter_vec; }
+    auto GetOptions() { return sim_options; }
 
     bool ParserFinalCheck();
 
@@ -54,14 +66,31 @@ class Parser {
     DcAnalysis dc_analysis;
     AcAnalysis ac_analysis;
     TranAnalysis tran_analysis;
+    FaultAnalysis fault_analysis;
+    SensAnalysis sens_analysis;
+    TfAnalysis tf_analysis;
+    PzAnalysis pz_analysis;
+    NoiseAnalysis noise_analysis;
+    HbAnalysis hb_analysis;
+    PssAnalysis pss_analysis;
+    SimOptions sim_options;
 
     std::vector<PrintVariable> print_variable_vec;
+    std::vector<NodeVoltage> ic_vec;
+    std::vector<NodeVoltage> nodeset_vec;
+    std::vector<ElementChange> alter_vec;
     PrintType print_type;
 
     double ParseValue(const QString value_in_str);
     void ParseError(const QString error_msg, const QString name, const int lineNum);
 
     void PrintCommandParser(const QStringList elements);
+    void OptionsCommandParser(const QStringList elements, const int lineNum);
+    bool NodeVoltageParser(const QStringList elements, const int lineNum,
+                           std::vector<NodeVoltage>& node_voltage_vec);
+    bool TransferCommandParser(const QStringList elements, const int lineNum,
+                               TfAnalysis& tf_analysis);
+    void ModelCommandParser(const QStringList elements, const int lineNum);
 
     void UpdateNodeVec();
 
@@ -69,6 +98,7 @@ class Parser {
     bool CheckNameRepetition(std::vector<T> struct_vec, DeviceName name);
 
     bool CheckGndNode();
+    bool CheckDiodeModel();
 };
 
 #endif  // PARSER_H
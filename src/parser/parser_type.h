@@ -15,9 +15,11 @@ typedef QString DeviceName;
 typedef QString NodeName;
 typedef QString ModelName;
 
-enum AnalysisType { NONE, DC, AC, TRAN, NOISE, DISTO };
+enum AnalysisType { NONE, DC, AC, TRAN, NOISE, DISTO, FAULT, SENS, TF, PZ, PSS, OP };
 typedef AnalysisType PrintType;
-const std::string AnalysisType_lookup[] = {"NONE", "DC", "AC", "TRAN", "NOISE", "DISTO"};
+const std::string AnalysisType_lookup[] = {"NONE",  "DC",    "AC",   "TRAN",
+                                            "NOISE", "DISTO", "FAULT", "SENS",
+                                            "TF",    "PZ",    "PSS",   "OP"};
 
 struct Pulse {
     bool chosen = false;
@@ -142,12 +144,20 @@ struct Diode {
         : name(name), node_1(node_1), node_2(node_2), model(model) {}
 };
 
+// I = i_sat * (e^{v / (n * THERMAL_VOLTAGE)} - 1)
+const double THERMAL_VOLTAGE = 0.025;
+
 struct DiodeModel {
     ModelName model;
     double i_sat;
+    double n;    // Emission coefficient
+    double tt;   // Transit time, diffusion capacitance tt * g_d
+    double cj0;  // Junction capacitance
 
     DiodeModel() {}
-    DiodeModel(ModelName model, double i_sat) : model(model), i_sat(i_sat) {}
+    DiodeModel(ModelName model, double i_sat, double n = 1, double tt = 0,
+               double cj0 = 0)
+        : model(model), i_sat(i_sat), n(n), tt(tt), cj0(cj0) {}
 };
 
 const std::vector<DiodeModel> diode_model_lut = {DiodeModel(QString("diode"), 1)};
@@ -162,6 +172,7 @@ struct Circuit {
     std::vector<Ind> ind_vec;
     std::vector<Diode> diode_vec;
     std::vector<NodeName> node_vec;
+    std::vector<DiodeModel> diode_model_vec = diode_model_lut;  // and the .model ones
 };
 
 // TODO: CC
@@ -191,11 +202,54 @@ struct AcAnalysis {
     double f_end;
 };
 
-// t_step; t_stop; t_start
+// t_step; t_stop; t_start; uic
 struct TranAnalysis {
     double t_step;
     double t_stop;
     double t_start;
+    bool uic = false;  // Start from .ic, no operating point
+};
+
+// .alter device value, a what-if change solved after the analysis
+struct ElementChange {
+    DeviceName name;
+    double value;
+};
+
+// .ic / .nodeset v(node)=value ...
+struct NodeVoltage {
+    NodeName node;
+    double value;
+};
+
+// .fault [device ...]; every device when none is given
+struct FaultAnalysis {
+    std::vector<DeviceName> device_vec;
+};
+
+// .sens v(node) ...
+struct SensAnalysis {
+    std::vector<NodeName> output_vec;
+};
+
+// Transient integration: Backward Euler, the Krylov exponential integrator
+// for linear circuits, multirate Backward Euler on partitions, waveform
+// relaxation of the partitions on threads, or Parareal time slices on threads
+enum TranMethod { BE, EXPINT, MULTIRATE, WR, PARAREAL };
+const std::vector<std::string> TranMethod_lookup = {"be", "expint", "multirate", "wr",
+                                                    "parareal"};
+
+// .options ptran chord opcache vntol=1u abstol=1p reltol=1m itl1=100
+//          method=expint|...
+struct SimOptions {
+    bool pseudo_tran = false;  // Pseudo-transient continuation for DC points
+    bool chord = false;        // Chord Newton, reusing the LU factorization
+    bool op_cache = false;     // Warm start nonlinear DC from the last run
+    double vntol = 1e-6;       // Absolute voltage tolerance
+    double abstol = 1e-12;     // Absolute current tolerance
+    double reltol = 1e-3;      // Relative tolerance
+    int itl1 = 100;            // Newton iteration cap
+    TranMethod tran_method = BE;
 };
 
 enum AnalysisVariableT { MAG, REAL, IMAGINE, PHASE, DB };
@@ -211,4 +265,33 @@ struct PrintVariable {
     NodeName node;
 };
 
+// .tf v(node_1[,node_2]) src / .tf i(vsrc) src
+struct TfAnalysis {
+    PrintIV out_i_v;
+    NodeName out_node_1;  // The Vsrc name for a current output
+    NodeName out_node_2;  // "0" if not given
+    DeviceName src_name;
+};
+
+// .pz takes the same output and input as .tf
+typedef TfAnalysis PzAnalysis;
+
+// .noise v(node_1[,node_2]) src dec|oct|lin points f_start f_end
+struct NoiseAnalysis {
+    TfAnalysis transfer;
+    AcAnalysis sweep;
+};
+
+// .hb f0 harmonic_num, periodic steady state with fundamental f0
+struct HbAnalysis {
+    double f0;
+    int harmonic_num;
+};
+
+// .pss t_step period, one period of Backward Euler steps of t_step
+struct PssAnalysis {
+    double t_step;
+    double period;
+};
+
 #endif  // PARSERTYPE_H
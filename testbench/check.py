@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""Run the testbenches and compare their output with their Expect lines.
+
+Each bench states what a correct run prints in its comments:
+
+    * Expect: Transfer function v(2) / v1 = 0.25
+    * Expect ~0.5%: v(2) = 0.632 at time = 1m
+    * Absent: Warm start from the cached operating point
+    * Runs: 2
+
+An Expect line passes when some output line has the same words, with every
+number within the tolerance: 0.1% by default, `~x%` relative or `~x` absolute.
+Numbers in Expect lines may carry SPICE suffixes (1m, 4k, 1meg). An Absent
+line passes when no output line matches it. With `Runs: n` the bench is run
+n times and the last output is checked. Every bench gets its own empty cache
+directory.
+
+Usage: testbench/check.py [--bin ./simpleEDA] [bench.sp ...]
+       (default: every testbench/analysis/*.sp)
+"""
+
+import argparse
+import glob
+import math
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+REL_TOL = 1e-3
+ABS_TOL = 1e-12
+RUN_TIMEOUT = 600  # seconds
+
+SCALE = {"f": 1e-15, "p": 1e-12, "n": 1e-9, "u": 1e-6, "m": 1e-3, "k": 1e3,
+         "meg": 1e6, "g": 1e9, "t": 1e12}
+SPICE_NUMBER_RE = re.compile(
+    r"^([-+]?(?:\d+\.?\d*|\.\d+)(?:e[-+]?\d+)?)(meg|[fpnumkgt])?$", re.I)
+DIRECTIVE_RE = re.compile(r"^\*\s*(Expect|Absent)\s*(?:~(\S+))?\s*:\s*(.+)$")
+RUNS_RE = re.compile(r"^\*\s*Runs\s*:\s*(\d+)\s*$")
+
+
+def spice_number(token):
+    """The value of a number with an optional SPICE suffix, None otherwise."""
+    if token.lower() in ("nan", "inf", "-inf"):
+        return float(token)
+    match = SPICE_NUMBER_RE.match(token)
+    if not match:
+        return None
+    value = float(match.group(1))
+    if match.group(2):
+        value *= SCALE[match.group(2).lower()]
+    return value
+
+
+def output_number(token):
+    """The value of a number as the program prints it, None otherwise."""
+    try:
+        return float(token)
+    except ValueError:
+        return None
+
+
+class Check:
+    def __init__(self, kind, tol, text, line_num):
+        self.kind = kind  # "Expect" or "Absent"
+        self.text = text
+        self.line_num = line_num
+        self.rel_tol = REL_TOL
+        self.abs_tol = ABS_TOL
+        if tol:
+            if tol.endswith("%"):
+                self.rel_tol = float(tol[:-1]) / 100
+            else:
+                self.abs_tol = spice_number(tol)
+                if self.abs_tol is None:
+                    raise ValueError("invalid tolerance " + tol)
+        self.token_vec = [(token, spice_number(token)) for token in text.split()]
+
+    def matches(self, line):
+        token_vec = line.split()
+        if len(token_vec) != len(self.token_vec):
+            return False
+        for token, (expected, expected_value) in zip(token_vec, self.token_vec):
+            value = output_number(token) if expected_value is not None else None
+            if value is None:
+                if token != expected:
+                    return False
+            elif math.isnan(expected_value) or math.isnan(value):
+                if not (math.isnan(expected_value) and math.isnan(value)):
+                    return False
+            elif abs(value - expected_value) > max(
+                    self.abs_tol, self.rel_tol * abs(expected_value)):
+                return False
+        return True
+
+
+def read_bench(path):
+    check_vec = []
+    run_num = 1
+    with open(path) as bench:
+        for line_num, line in enumerate(bench, 1):
+            line = line.strip()
+            match = DIRECTIVE_RE.match(line)
+            if match:
+                check_vec.append(Check(match.group(1), match.group(2),
+                                       match.group(3).strip(), line_num))
+                continue
+            match = RUNS_RE.match(line)
+            if match:
+                run_num = int(match.group(1))
+    return check_vec, run_num
+
+
+def run_bench(binary, path, run_num):
+    env = dict(os.environ)
+    env.setdefault("QT_QPA_PLATFORM", "offscreen")
+    with tempfile.TemporaryDirectory() as cache_dir:
+        env["XDG_CACHE_HOME"] = cache_dir
+        for _ in range(run_num):
+            process = subprocess.run([binary, path], env=env, cwd=ROOT,
+                                     stdout=subprocess.PIPE,
+                                     stderr=subprocess.STDOUT,
+                                     universal_newlines=True,
+                                     timeout=RUN_TIMEOUT)
+    return process.returncode, process.stdout.splitlines()
+
+
+def main():
+    arg_parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    arg_parser.add_argument("--bin", default=os.path.join(ROOT, "simpleEDA"))
+    arg_parser.add_argument("--verbose", action="store_true",
+                            help="print the output of failed benches")
+    arg_parser.add_argument("bench", nargs="*")
+    args = arg_parser.parse_args()
+
+    bench_vec = args.bench or sorted(
+        glob.glob(os.path.join(ROOT, "testbench", "analysis", "*.sp")))
+    if not os.access(args.bin, os.X_OK):
+        print("Cannot run %s, build it first (xmake)" % args.bin)
+        return 2
+
+    fail_num = 0
+    for bench in bench_vec:
+        name = os.path.relpath(bench, ROOT)
+        check_vec, run_num = read_bench(bench)
+        if not check_vec:
+            print("FAIL %s: no Expect lines" % name)
+            fail_num += 1
+            continue
+
+        try:
+            return_code, line_vec = run_bench(args.bin, bench, run_num)
+        except subprocess.TimeoutExpired:
+            print("FAIL %s: no result after %d s" % (name, RUN_TIMEOUT))
+            fail_num += 1
+            continue
+
+        failed_vec = []
+        if return_code != 0:
+            failed_vec.append("exit code %d" % return_code)
+        for check in check_vec:
+            found = any(check.matches(line) for line in line_vec)
+            if found != (check.kind == "Expect"):
+                failed_vec.append("line %d: %s: %s" %
+                                  (check.line_num, check.kind, check.text))
+
+        if failed_vec:
+            fail_num += 1
+            print("FAIL %s" % name)
+            for failed in failed_vec:
+                print("  " + failed)
+            if args.verbose:
+                print("\n".join("  | " + line for line in line_vec))
+        else:
+            print("ok   %s (%d checks)" % (name, len(check_vec)))
+
+    print("%d of %d benches passed" % (len(bench_vec) - fail_num, len(bench_vec)))
+    return 1 if fail_num else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
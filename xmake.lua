@@ -12,6 +12,7 @@ target("simpleEDA")
     add_rpathdirs("lib/")
     add_links("armadillo")
     add_links("qcustomplot")
+    add_syslinks("pthread")
 
 
     add_files("src/mainwindow/mainwindow.h")